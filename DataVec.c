@@ -0,0 +1,149 @@
+#include "DataVec.h"
+#include "Stats.h"
+
+#include <string.h>
+
+static bool is_local( const DataVec* vec )
+{
+   return vec->capacity <= DATAVEC_INLINE;
+}
+
+static bool grow( DataVec* vec, int capacity )
+{
+   Data* heap;
+   if( is_local( vec ) )
+   {
+      heap = (Data*) malloc( capacity * sizeof( Data ) );
+      if( !heap ) return false;
+
+      memcpy( heap, vec->items.local, vec->len * sizeof( Data ) );
+   }
+   else
+   {
+      heap = (Data*) realloc( vec->items.heap, capacity * sizeof( Data ) );
+      if( !heap ) return false;
+   }
+
+   vec->items.heap = heap;
+   vec->capacity = capacity;
+   STATS_ALLOC( capacity * sizeof( Data ) );
+   return true;
+}
+
+
+void DataVec_Init( DataVec* vec )
+{
+   assert( vec );
+
+   vec->len = 0;
+   vec->capacity = DATAVEC_INLINE;
+   vec->cursor = 0;
+}
+
+void DataVec_Destroy( DataVec* vec )
+{
+   assert( vec );
+
+   if( !is_local( vec ) ) free( vec->items.heap );
+
+   DataVec_Init( vec );
+}
+
+bool DataVec_Push_back( DataVec* vec, int index, float weight )
+{
+   assert( vec );
+
+   if( vec->len == vec->capacity && !grow( vec, 2 * vec->capacity ) ) return false;
+
+   Data* d = &DataVec_Items( vec )[ vec->len ];
+   d->index = index;
+   d->weight = weight;
+
+   ++vec->len;
+   return true;
+}
+
+bool DataVec_Reserve( DataVec* vec, int capacity )
+{
+   assert( vec );
+
+   if( capacity <= vec->capacity ) return true;
+
+   return grow( vec, capacity > 2 * vec->capacity ? capacity : 2 * vec->capacity );
+   // al menos se duplica, como en DataVec_Push_back(): reservar un poco más en cada lote no debe
+   // copiar al arreglo completo cada vez
+}
+
+void DataVec_Swap_remove( DataVec* vec, int pos )
+{
+   assert( vec );
+   assert( 0 <= pos && pos < vec->len );
+
+   Data* items = DataVec_Items( vec );
+   items[ pos ] = items[ vec->len - 1 ];
+   --vec->len;
+}
+
+void DataVec_Remove_marked( DataVec* vec, const bool* drop )
+{
+   assert( vec );
+
+   Data* items = DataVec_Items( vec );
+
+   int len = 0;
+   for( int i = 0; i < vec->len; ++i )
+   {
+      if( !drop[ i ] ) items[ len++ ] = items[ i ];
+   }
+   vec->len = len;
+}
+
+int DataVec_Len( const DataVec* vec )
+{
+   return vec->len;
+}
+
+bool DataVec_Is_empty( const DataVec* vec )
+{
+   return vec->len == 0;
+}
+
+Data* DataVec_Items( DataVec* vec )
+{
+   return is_local( vec ) ? vec->items.local : vec->items.heap;
+}
+
+const Data* DataVec_Items_const( const DataVec* vec )
+{
+   return is_local( vec ) ? vec->items.local : vec->items.heap;
+}
+
+void DataVec_Cursor_front( DataVec* vec )
+{
+   assert( vec );
+
+   vec->cursor = 0;
+}
+
+bool DataVec_Cursor_next( DataVec* vec )
+{
+   assert( vec );
+
+   ++vec->cursor;
+   return vec->cursor < vec->len;
+}
+
+bool DataVec_Cursor_end( const DataVec* vec )
+{
+   assert( vec );
+
+   return vec->cursor >= vec->len;
+}
+
+Data DataVec_Cursor_get( const DataVec* vec )
+{
+   assert( vec );
+   assert( vec->cursor < vec->len );
+
+   return DataVec_Items_const( vec )[ vec->cursor ];
+}
@@ -0,0 +1,97 @@
+#ifndef  DATAVEC_INC
+#define  DATAVEC_INC
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "List.h"
+// Data está definida aquí
+
+#ifndef DATAVEC_INLINE
+#define DATAVEC_INLINE 8
+#endif
+
+/**
+ * @brief Arreglo dinámico de Data con búfer interno para pocos elementos.
+ *
+ * Mientras tenga a lo más DATAVEC_INLINE elementos no pide memoria al sistema; después crece al
+ * doble cada vez que se llena. Los elementos siempre están contiguos en memoria.
+ */
+typedef struct
+{
+   int len;       ///< número de elementos
+   int capacity;  ///< DATAVEC_INLINE mientras se usa el búfer interno
+   int cursor;    ///< posición del cursor; len indica el final
+
+   union
+   {
+      Data local[ DATAVEC_INLINE ];
+      Data* heap;
+   } items;
+} DataVec;
+
+/**
+ * @brief Inicializa un arreglo vacío.
+ */
+void DataVec_Init( DataVec* vec );
+
+/**
+ * @brief Libera la memoria del arreglo (si es que pidió) y lo deja vacío.
+ */
+void DataVec_Destroy( DataVec* vec );
+
+/**
+ * @brief Inserta un elemento al final. Costo amortizado O(1).
+ *
+ * @return false si se agotó la memoria; true en caso contrario.
+ */
+bool DataVec_Push_back( DataVec* vec, int index, float weight );
+
+/**
+ * @brief Garantiza que quepan |capacity| elementos sin volver a pedir memoria.
+ *
+ * Si hace falta crecer, la capacidad al menos se duplica, así que una serie de reservas
+ * crecientes cuesta O(1) amortizado por elemento.
+ *
+ * @return false si se agotó la memoria; true en caso contrario.
+ */
+bool DataVec_Reserve( DataVec* vec, int capacity );
+
+/**
+ * @brief Elimina el elemento en la posición |pos| moviendo al último a su lugar. O(1).
+ *
+ * @post El orden de los elementos restantes puede cambiar.
+ */
+void DataVec_Swap_remove( DataVec* vec, int pos );
+
+/**
+ * @brief Elimina los elementos marcados conservando el orden de los demás. O(len).
+ *
+ * @param drop Arreglo de len elementos; drop[ i ] indica si el elemento i se elimina.
+ */
+void DataVec_Remove_marked( DataVec* vec, const bool* drop );
+
+int DataVec_Len( const DataVec* vec );
+bool DataVec_Is_empty( const DataVec* vec );
+
+/**
+ * @brief Devuelve un apuntador a los elementos, que están contiguos.
+ *
+ * @post El apuntador deja de ser válido en cuanto el arreglo se modifique.
+ */
+Data* DataVec_Items( DataVec* vec );
+const Data* DataVec_Items_const( const DataVec* vec );
+
+void DataVec_Cursor_front( DataVec* vec );
+bool DataVec_Cursor_next( DataVec* vec );
+bool DataVec_Cursor_end( const DataVec* vec );
+
+/**
+ * @brief Devuelve una copia del elemento apuntado por el cursor.
+ *
+ * @pre El cursor debe apuntar a una posición válida.
+ */
+Data DataVec_Cursor_get( const DataVec* vec );
+
+#endif   /* ----- #ifndef DATAVEC_INC  ----- */
@@ -0,0 +1,139 @@
+#include "EdgeSet.h"
+#include "Stats.h"
+
+#define EDGESET_EMPTY UINT64_MAX
+
+// La carga se mantiene por debajo de 1/2 para que las cadenas de prueba sean cortas.
+#define EDGESET_MIN_BITS 4
+
+static uint64_t key_of( int src, int dst )
+{
+   return ( (uint64_t) (uint32_t) src << 32 ) | (uint32_t) dst;
+}
+
+static size_t slot_of( const EdgeSet* set, uint64_t key )
+{
+   // hash multiplicativo de Fibonacci: los bits altos del producto dependen de toda la llave
+   return (size_t) ( ( key * 0x9E3779B97F4A7C15ull ) >> ( 64 - set->bits ) );
+}
+
+static uint64_t* new_slots( size_t capacity )
+{
+   uint64_t* slots = (uint64_t*) malloc( capacity * sizeof( uint64_t ) );
+   if( slots )
+   {
+      STATS_ALLOC( capacity * sizeof( uint64_t ) );
+      for( size_t i = 0; i < capacity; ++i ) slots[ i ] = EDGESET_EMPTY;
+   }
+   return slots;
+}
+
+static bool grow( EdgeSet* set )
+{
+   size_t old_capacity = set->capacity;
+   uint64_t* old = set->slots;
+
+   uint64_t* slots = new_slots( old_capacity * 2 );
+   if( !slots ) return false;
+
+   set->slots = slots;
+   set->capacity = old_capacity * 2;
+   ++set->bits;
+
+   for( size_t i = 0; i < old_capacity; ++i )
+   {
+      if( old[ i ] != EDGESET_EMPTY )
+      {
+         size_t s = slot_of( set, old[ i ] );
+         while( set->slots[ s ] != EDGESET_EMPTY ) s = ( s + 1 ) & ( set->capacity - 1 );
+
+         set->slots[ s ] = old[ i ];
+      }
+   }
+
+   free( old );
+   return true;
+}
+
+
+EdgeSet* EdgeSet_New( size_t expected )
+{
+   EdgeSet* set = (EdgeSet*) malloc( sizeof( EdgeSet ) );
+   if( set )
+   {
+      set->bits = EDGESET_MIN_BITS;
+      while( ( (size_t) 1 << set->bits ) < 2 * expected ) ++set->bits;
+
+      set->capacity = (size_t) 1 << set->bits;
+      set->len = 0;
+      set->slots = new_slots( set->capacity );
+      if( !set->slots )
+      {
+         free( set );
+         set = NULL;
+      }
+   }
+
+   return set;
+}
+
+void EdgeSet_Delete( EdgeSet** p_set )
+{
+   assert( *p_set );
+
+   free( (*p_set)->slots );
+   free( *p_set );
+   *p_set = NULL;
+}
+
+bool EdgeSet_Insert( EdgeSet* set, int src, int dst )
+{
+   assert( set );
+   assert( src >= 0 && dst >= 0 );
+
+   if( 2 * ( set->len + 1 ) > set->capacity && !grow( set ) ) return false;
+
+   uint64_t key = key_of( src, dst );
+
+   size_t s = slot_of( set, key );
+   while( set->slots[ s ] != EDGESET_EMPTY )
+   {
+      if( set->slots[ s ] == key ) return false;
+
+      s = ( s + 1 ) & ( set->capacity - 1 );
+   }
+
+   set->slots[ s ] = key;
+   ++set->len;
+   return true;
+}
+
+bool EdgeSet_Contains( const EdgeSet* set, int src, int dst )
+{
+   assert( set );
+
+   uint64_t key = key_of( src, dst );
+
+   size_t s = slot_of( set, key );
+   while( set->slots[ s ] != EDGESET_EMPTY )
+   {
+      if( set->slots[ s ] == key ) return true;
+
+      s = ( s + 1 ) & ( set->capacity - 1 );
+   }
+
+   return false;
+}
+
+void EdgeSet_Clear( EdgeSet* set )
+{
+   assert( set );
+
+   for( size_t i = 0; i < set->capacity; ++i ) set->slots[ i ] = EDGESET_EMPTY;
+   set->len = 0;
+}
+
+size_t EdgeSet_Len( const EdgeSet* set )
+{
+   return set->len;
+}
@@ -0,0 +1,47 @@
+#ifndef  EDGESET_INC
+#define  EDGESET_INC
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+/**
+ * @brief Conjunto de aristas (origen, destino) implementado como tabla hash con direccionamiento
+ * abierto (prueba lineal). Ambos extremos son índices no negativos.
+ */
+typedef struct
+{
+   uint64_t* slots;   ///< UINT64_MAX indica una casilla libre
+   size_t capacity;   ///< siempre es una potencia de 2
+   unsigned bits;     ///< log2( capacity )
+   size_t len;        ///< número de aristas en el conjunto
+} EdgeSet;
+
+/**
+ * @brief Crea un conjunto vacío.
+ *
+ * @param expected Número de aristas que se espera guardar. El conjunto crece solo si se rebasa.
+ *
+ * @return Un nuevo conjunto, o NULL si se agotó la memoria.
+ */
+EdgeSet* EdgeSet_New( size_t expected );
+void EdgeSet_Delete( EdgeSet** p_set );
+
+/**
+ * @brief Agrega la arista (src, dst) al conjunto.
+ *
+ * @return true si la arista no estaba y se agregó; false si ya estaba o si se agotó la memoria.
+ */
+bool EdgeSet_Insert( EdgeSet* set, int src, int dst );
+
+/**
+ * @brief Indica si la arista (src, dst) está en el conjunto.
+ */
+bool EdgeSet_Contains( const EdgeSet* set, int src, int dst );
+
+void EdgeSet_Clear( EdgeSet* set );
+
+size_t EdgeSet_Len( const EdgeSet* set );
+
+#endif   /* ----- #ifndef EDGESET_INC  ----- */
@@ -0,0 +1,4413 @@
+#define _POSIX_C_SOURCE 200809L
+// pthread_barrier_t, sched_yield(), sysconf() y mmap() son POSIX, no C99
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Graph.h"
+#include "Trace.h"
+#include "Stats.h"
+
+
+//----------------------------------------------------------------------
+//                           Vertex stuff:
+//----------------------------------------------------------------------
+
+
+static void VertexState_Init( VertexState* state )
+{
+   state->color = NULL;
+   state->predecessor = state->discovery_time = state->finish_time = state->distance = NULL;
+   state->stamp = NULL;
+   state->epoch = 1;
+   state->capacity = 0;
+}
+
+/**
+ * @brief Empieza una consulta nueva: todos los vértices quedan WHITE en O(1).
+ *
+ * Cuando la época da la vuelta se limpian todas las marcas, lo cual ocurre una vez cada 2^32 - 1
+ * consultas.
+ */
+static void VertexState_Clear( VertexState* state )
+{
+   ++state->epoch;
+
+   if( state->epoch == 0 )
+   {
+      memset( state->stamp, 0, state->capacity * sizeof( uint32_t ) );
+      state->epoch = 1;
+   }
+}
+
+static bool state_is_fresh( const VertexState* state, int v )
+{
+   return state->stamp[ v ] == state->epoch;
+}
+
+// inicializa los campos de |v| la primera vez que se escriben en la consulta actual
+static void state_touch( VertexState* state, int v )
+{
+   if( state->stamp[ v ] != state->epoch )
+   {
+      state->stamp[ v ] = state->epoch;
+
+      state->color[ v ] = WHITE;
+      state->predecessor[ v ] = -1;
+      state->discovery_time[ v ] = 0;
+      state->finish_time[ v ] = 0;
+      state->distance[ v ] = -1;
+   }
+}
+
+static eGraphColors state_color( const VertexState* state, int v )
+{
+   return state_is_fresh( state, v ) ? (eGraphColors) state->color[ v ] : WHITE;
+}
+
+// agranda (realloc) un arreglo de |old_n| a |new_n| elementos de |elem| bytes; los nuevos quedan en 0
+static bool grow_array( void** array, int old_n, int new_n, size_t elem )
+{
+   void* p = realloc( *array, new_n * elem );
+   if( !p ) return false;
+
+   memset( (char*) p + old_n * elem, 0, ( new_n - old_n ) * elem );
+   *array = p;
+   return true;
+}
+
+// reduce el arreglo a |n| elementos; si realloc() falla se queda con el bloque original
+static void shrink_array( void** array, int n, size_t elem )
+{
+   void* p = realloc( *array, n * elem );
+   if( p ) *array = p;
+}
+
+// garantiza que haya lugar para |capacity| vértices; los nuevos elementos quedan en 0
+static bool VertexState_Reserve( VertexState* state, int capacity )
+{
+   if( capacity <= state->capacity ) return true;
+
+   int old = state->capacity;
+
+   if( !grow_array( (void**) &state->color,          old, capacity, sizeof( uint8_t ) ) ) return false;
+   if( !grow_array( (void**) &state->predecessor,    old, capacity, sizeof( int32_t ) ) ) return false;
+   if( !grow_array( (void**) &state->discovery_time, old, capacity, sizeof( int32_t ) ) ) return false;
+   if( !grow_array( (void**) &state->finish_time,    old, capacity, sizeof( int32_t ) ) ) return false;
+   if( !grow_array( (void**) &state->distance,       old, capacity, sizeof( int32_t ) ) ) return false;
+   if( !grow_array( (void**) &state->stamp,          old, capacity, sizeof( uint32_t ) ) ) return false;
+   // los vértices nuevos tienen marca 0, que nunca es una época válida
+
+   STATS_ADD( allocations, 6 );
+   STATS_ADD( bytes_allocated, capacity * ( sizeof( uint8_t ) + 4 * sizeof( int32_t ) + sizeof( uint32_t ) ) );
+
+   state->capacity = capacity;
+   return true;
+}
+
+static void VertexState_Destroy( VertexState* state )
+{
+   free( state->color );
+   free( state->predecessor );
+   free( state->discovery_time );
+   free( state->finish_time );
+   free( state->distance );
+   free( state->stamp );
+
+   state->capacity = 0;
+}
+
+bool Vertex_HasNeighbors( const Vertex* v )
+{
+   assert( v );
+
+#if VERTEX_USE_SMALLVEC
+   return !DataVec_Is_empty( &v->neighbors );
+#else
+   return v->neighbors;
+#endif
+}
+
+static NeighborPos list_begin( const NeighborList* list )
+{
+#if VERTEX_USE_SMALLVEC
+   return DataVec_Items_const( list );
+#else
+   return *list ? (*list)->first : NULL;
+#endif
+}
+
+static bool list_end( const NeighborList* list, NeighborPos pos )
+{
+#if VERTEX_USE_SMALLVEC
+   return pos == DataVec_Items_const( list ) + DataVec_Len( list );
+#else
+   (void) list;
+   return pos == NULL;
+#endif
+}
+
+static NeighborPos neighbors_begin( const Vertex* v )
+{
+   return list_begin( &v->neighbors );
+}
+
+static bool neighbors_end( const Vertex* v, NeighborPos pos )
+{
+   return list_end( &v->neighbors, pos );
+}
+
+static NeighborPos neighbors_next( NeighborPos pos )
+{
+#if VERTEX_USE_SMALLVEC
+   return pos + 1;
+#else
+   return pos->next;
+#endif
+}
+
+static Data neighbors_get( NeighborPos pos )
+{
+#if VERTEX_USE_SMALLVEC
+   return *pos;
+#else
+   return pos->data;
+#endif
+}
+
+/**
+ * @brief Coloca al iterador en el primer vecino de |v|.
+ *
+ * @param it El iterador.
+ * @param v  El vértice de trabajo.
+ */
+void NeighborIter_Start( NeighborIter* it, const Vertex* v )
+{
+   assert( it );
+   assert( v );
+
+   it->list = &v->neighbors;
+   it->pos = list_begin( it->list );
+}
+
+/**
+ * @brief Indica si el iterador ya pasó por todos los vecinos.
+ */
+bool NeighborIter_End( const NeighborIter* it )
+{
+   return list_end( it->list, it->pos );
+}
+
+/**
+ * @brief Mueve al iterador al siguiente vecino.
+ *
+ * @pre El iterador no ha llegado al final.
+ */
+void NeighborIter_Next( NeighborIter* it )
+{
+   it->pos = neighbors_next( it->pos );
+}
+
+/**
+ * @brief Devuelve el vecino (su índice y el peso de la arista) al que apunta el iterador.
+ *
+ * @pre El iterador no ha llegado al final.
+ */
+Data NeighborIter_Get( const NeighborIter* it )
+{
+   return neighbors_get( it->pos );
+}
+
+static int neighbors_len( const Vertex* v )
+{
+   return v->out_degree;
+}
+
+
+//----------------------------------------------------------------------
+//                      Traversal context stuff:
+//----------------------------------------------------------------------
+
+#define DFS_STACK_INITIAL 64
+
+static void TraversalContext_Init( TraversalContext* ctx )
+{
+   VertexState_Init( &ctx->state );
+   ctx->stack = NULL;
+   ctx->stack_capacity = 0;
+   ctx->output = NULL;
+   ctx->output_len = 0;
+   ctx->time = 0;
+}
+
+static void TraversalContext_Destroy( TraversalContext* ctx )
+{
+   VertexState_Destroy( &ctx->state );
+   free( ctx->stack );
+   free( ctx->output );
+   TraversalContext_Init( ctx );
+}
+
+// garantiza que haya lugar para los |len| vértices de un grafo
+static bool ctx_reserve( TraversalContext* ctx, int len )
+{
+   if( len <= ctx->state.capacity ) return true;
+
+   int* output = (int*) realloc( ctx->output, len * sizeof( int ) );
+   if( !output ) return false;
+   ctx->output = output;
+   STATS_ALLOC( len * sizeof( int ) );
+
+   return VertexState_Reserve( &ctx->state, len );
+}
+
+// libera la memoria que sobra después de los primeros |len| vértices
+static void ctx_shrink( TraversalContext* ctx, int len )
+{
+   if( len >= ctx->state.capacity ) return;
+   if( len < 1 ) len = 1;
+
+   VertexState* state = &ctx->state;
+
+   shrink_array( (void**) &ctx->output,           len, sizeof( int ) );
+   shrink_array( (void**) &state->color,          len, sizeof( uint8_t ) );
+   shrink_array( (void**) &state->predecessor,    len, sizeof( int32_t ) );
+   shrink_array( (void**) &state->discovery_time, len, sizeof( int32_t ) );
+   shrink_array( (void**) &state->finish_time,    len, sizeof( int32_t ) );
+   shrink_array( (void**) &state->distance,       len, sizeof( int32_t ) );
+   shrink_array( (void**) &state->stamp,          len, sizeof( uint32_t ) );
+
+   state->capacity = len;
+}
+
+// prepara al contexto para una consulta nueva en O(1)
+static void ctx_reset( TraversalContext* ctx )
+{
+   VertexState_Clear( &ctx->state );
+
+   ctx->output_len = 0;
+   ctx->time = 0;
+}
+
+// agrega un marco a la pila, agrandándola si hace falta; false si se agotó la memoria (la pila
+// queda como estaba)
+static bool ctx_push( TraversalContext* ctx, int* top, int vertex, NeighborPos pos )
+{
+   if( *top == ctx->stack_capacity )
+   {
+      int capacity = ctx->stack_capacity ? 2 * ctx->stack_capacity : DFS_STACK_INITIAL;
+      DfsFrame* stack = (DfsFrame*) realloc( ctx->stack, capacity * sizeof( DfsFrame ) );
+      if( !stack ) return false;
+      STATS_ALLOC( capacity * sizeof( DfsFrame ) );
+
+      ctx->stack = stack;
+      ctx->stack_capacity = capacity;
+   }
+
+   ctx->stack[ *top ].vertex = vertex;
+   ctx->stack[ *top ].pos = pos;
+   ++*top;
+   STATS_MAX( stack_high_water, *top );
+   return true;
+}
+
+/**
+ * @brief Crea un contexto de recorrido vacío.
+ *
+ * @return Un nuevo contexto, o NULL si se agotó la memoria.
+ */
+TraversalContext* TraversalContext_New()
+{
+   TraversalContext* ctx = (TraversalContext*) malloc( sizeof( TraversalContext ) );
+   if( ctx ) TraversalContext_Init( ctx );
+
+   return ctx;
+}
+
+void TraversalContext_Delete( TraversalContext** ctx )
+{
+   assert( *ctx );
+
+   TraversalContext_Destroy( *ctx );
+   free( *ctx );
+   *ctx = NULL;
+}
+
+/**
+ * @brief Devuelve los índices de los vértices en el orden en que los produjo el último recorrido
+ * (orden posterior para la búsqueda en profundidad; orden de descubrimiento para la búsqueda en
+ * amplitud).
+ */
+const int* TraversalContext_GetOutput( const TraversalContext* ctx )
+{
+   return ctx->output;
+}
+
+int TraversalContext_GetOutputLen( const TraversalContext* ctx )
+{
+   return ctx->output_len;
+}
+
+eGraphColors TraversalContext_GetColor( const TraversalContext* ctx, int vertex_idx )
+{
+   return state_color( &ctx->state, vertex_idx );
+}
+
+/**
+ * @brief Devuelve el índice del predecesor del vértice en el último recorrido; -1 si no tiene.
+ */
+int TraversalContext_GetPredecessor( const TraversalContext* ctx, int vertex_idx )
+{
+   return state_is_fresh( &ctx->state, vertex_idx ) ? ctx->state.predecessor[ vertex_idx ] : -1;
+}
+
+int TraversalContext_GetDiscovery_time( const TraversalContext* ctx, int vertex_idx )
+{
+   return state_is_fresh( &ctx->state, vertex_idx ) ? ctx->state.discovery_time[ vertex_idx ] : 0;
+}
+
+int TraversalContext_GetFinish_time( const TraversalContext* ctx, int vertex_idx )
+{
+   return state_is_fresh( &ctx->state, vertex_idx ) ? ctx->state.finish_time[ vertex_idx ] : 0;
+}
+
+int TraversalContext_GetDistance( const TraversalContext* ctx, int vertex_idx )
+{
+   return state_is_fresh( &ctx->state, vertex_idx ) ? ctx->state.distance[ vertex_idx ] : -1;
+}
+
+/**
+ * @brief Hace que cursor libre apunte al inicio de la lista de vecinos. Se debe
+ * de llamar siempre que se vaya a iniciar un recorrido de dicha lista.
+ *
+ * @param v El vértice de trabajo (es decir, el vértice del cual queremos obtener
+ * la lista de vecinos).
+ *
+ * @note El cursor es uno solo por vértice, así que dos recorridos no pueden usarlo al mismo
+ * tiempo. Para recorridos anidados o concurrentes use NeighborIter.
+ */
+void Vertex_Start( Vertex* v )
+{
+   assert( v );
+
+#if VERTEX_USE_SMALLVEC
+   DataVec_Cursor_front( &v->neighbors );
+#else
+   List_Cursor_front( v->neighbors );
+#endif
+}
+
+/**
+ * @brief Mueve al cursor libre un nodo adelante.
+ *
+ * @param v El vértice de trabajo.
+ *
+ * @pre El cursor apunta a un nodo válido.
+ * @post El cursor se movió un elemento a la derecha en la lista de vecinos.
+ */
+void Vertex_Next( Vertex* v )
+{
+#if VERTEX_USE_SMALLVEC
+   DataVec_Cursor_next( &v->neighbors );
+#else
+   List_Cursor_next( v->neighbors );
+#endif
+}
+
+/**
+ * @brief Indica si se alcanzó el final de la lista de vecinos.
+ *
+ * @param v El vértice de trabajo.
+ *
+ * @return true si se alcanazó el final de la lista; false en cualquier otro
+ * caso.
+ */
+bool Vertex_End( const Vertex* v )
+{
+#if VERTEX_USE_SMALLVEC
+   return DataVec_Cursor_end( &v->neighbors );
+#else
+   return List_Cursor_end( v->neighbors );
+#endif
+}
+
+
+/**
+ * @brief Devuelve el índice del vecino al que apunta actualmente el cursor en la lista de vecinos
+ * del vértice |v|.
+ *
+ * @param v El vértice de trabajo (del cual queremos conocer el índice de su vecino).
+ *
+ * @return El índice del vecino en la lista de vértices.
+ *
+ * @pre El cursor debe apuntar a un nodo válido en la lista de vecinos.
+ *
+ * Ejemplo
+ * @code
+   Vertex* v = Graph_GetVertexByKey( grafo, 100 );
+   for( Vertex_Start( v ); !Vertex_End( v ); Vertex_Next( v ) )
+   {
+      int index = Vertex_GetNeighborIndex( v );
+
+      Item val = Graph_GetDataByIndex( g, index );
+
+      // ...
+   }
+   @endcode
+   @note Esta función debe utilizarse únicamente cuando se recorra el grafo con las funciones
+   Vertex_Start(), Vertex_End() y Vertex_Next().
+ */
+Data Vertex_GetNeighborIndex( const Vertex* v )
+{
+#if VERTEX_USE_SMALLVEC
+   return DataVec_Cursor_get( &v->neighbors );
+#else
+   return List_Cursor_get( v->neighbors );
+#endif
+}
+
+void Vertex_SetColor( Vertex* v, eGraphColors color )
+{
+   state_touch( v->state, v->index );
+   v->state->color[ v->index ] = (uint8_t) color;
+}
+
+eGraphColors Vertex_GetColor( Vertex* v )
+{
+   return state_color( v->state, v->index );
+}
+
+int Vertex_GetData( const Vertex* v )
+{
+   return v->data;
+}
+
+void Vertex_SetPredecessor( Vertex* v, int predecessor_idx )
+{
+    state_touch( v->state, v->index );
+    v->state->predecessor[ v->index ] = predecessor_idx;
+}
+
+int Vertex_GetPredecessor( const Vertex* v )
+{
+    return state_is_fresh( v->state, v->index ) ? v->state->predecessor[ v->index ] : -1;
+}
+
+void Vertex_SetDiscovery_time( Vertex* v, int time )
+{
+    state_touch( v->state, v->index );
+    v->state->discovery_time[ v->index ] = time;
+}
+
+int Vertex_GetDiscovery_time( const Vertex* v )
+{
+    return state_is_fresh( v->state, v->index ) ? v->state->discovery_time[ v->index ] : 0;
+}
+
+void Vertex_SetFinish_time( Vertex* v, int time )
+{
+    state_touch( v->state, v->index );
+    v->state->finish_time[ v->index ] = time;
+}
+
+int Vertex_GetFinish_time( const Vertex* v )
+{
+    return state_is_fresh( v->state, v->index ) ? v->state->finish_time[ v->index ] : 0;
+}
+
+void Vertex_SetDistance( Vertex* v, int distance )
+{
+    state_touch( v->state, v->index );
+    v->state->distance[ v->index ] = distance;
+}
+
+int Vertex_GetDistance( const Vertex* v )
+{
+    return state_is_fresh( v->state, v->index ) ? v->state->distance[ v->index ] : -1;
+}
+
+
+//----------------------------------------------------------------------
+//                           Graph stuff:
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+//                     Funciones privadas
+//----------------------------------------------------------------------
+
+// g: el grafo
+// key: valor a buscar
+// ret: el índice del vértice con esa llave; -1 si no se encontró
+static int find( const Graph* g, int key )
+{
+   STATS_ADD( key_lookups, 1 );
+   return IntMap_Find( g->index, key );
+}
+
+// busca en el conjunto de aristas si la arista vertex_idx -> index ya existe; si no, la registra
+static bool is_new_edge( Graph* g, int vertex_idx, int index )
+{
+   if( g->dedup == eGraphDedup_DEFERRED ) return true;
+
+   if( EdgeSet_Insert( g->edges, vertex_idx, index ) ) return true;
+
+   assert( EdgeSet_Contains( g->edges, vertex_idx, index ) );
+   // si la arista no quedó registrada es porque se agotó la memoria
+   STATS_ADD( duplicate_edges, 1 );
+   return false;
+}
+
+// descarta lo que se calculó a partir de la estructura del grafo; se llama en cada cambio
+static void invalidate_cache( Graph* g )
+{
+   if( g->condensation ) Graph_Delete( &g->condensation );
+}
+
+// agrega |index| al final de |list|
+static void list_push( Graph* g, NeighborList* list, int index, float weigth )
+{
+#if VERTEX_USE_SMALLVEC
+   (void) g;
+   bool ok = DataVec_Push_back( list, index, weigth );
+   assert( ok );
+   (void) ok;
+#else
+   // crear la lista si no existe!
+   
+   if( !*list )
+   {
+      *list = List_New_from_pool( g->pool );
+   }
+   assert( *list );
+
+   List_Push_back( *list, index, weigth );
+#endif
+}
+
+static void list_init( NeighborList* list )
+{
+#if VERTEX_USE_SMALLVEC
+   DataVec_Init( list );
+#else
+   *list = NULL;
+#endif
+}
+
+static void list_destroy( NeighborList* list )
+{
+#if VERTEX_USE_SMALLVEC
+   DataVec_Destroy( list );
+#else
+   if( *list ) List_Release( list );
+#endif
+}
+
+// como list_destroy(), pero los nodos regresan a la arena para que los reutilicen las demás listas
+static void list_free( NeighborList* list )
+{
+#if VERTEX_USE_SMALLVEC
+   DataVec_Destroy( list );
+#else
+   if( *list ) List_Delete( list );
+#endif
+}
+
+// agrega |index| al final de la lista de vecinos de |vertex|, sin buscar duplicados; si se
+// mantienen los vecinos de entrada, también agrega a |vertex| a los de |index|
+static void push_neighbor( Graph* g, Vertex* vertex, int index, float weigth )
+{
+   invalidate_cache( g );
+
+   list_push( g, &vertex->neighbors, index, weigth );
+
+   ++vertex->out_degree;
+   ++g->vertices[ index ].in_degree;
+   if( g->in_neighbors ) list_push( g, &g->in_neighbors[ index ], vertex->index, weigth );
+}
+
+// g: el grafo
+// vertex_idx: índice del vértice de trabajo
+// index: índice en la lista de vértices del vértice vecino que está por insertarse
+static void insert( Graph* g, int vertex_idx, int index, float weigth )
+{
+   if( is_new_edge( g, vertex_idx, index ) )
+   {
+      push_neighbor( g, &g->vertices[ vertex_idx ], index, weigth );
+
+      TRACE_D( "insert():Inserting the neighbor with idx:%d\n", index );
+   }
+   else TRACE_D( "insert: duplicated index\n" );
+}
+
+
+//----------------------------------------------------------------------
+//                     Funciones públicas
+//----------------------------------------------------------------------
+
+
+/**
+ * @brief Crea un nuevo grafo.
+ *
+ * @param size Capacidad inicial (número de vértices). Si se agregan más vértices la capacidad
+ * crece sola (ver Graph_AddVertex() y Graph_Reserve()).
+ *
+ * @return Un nuevo grafo.
+ *
+ * @pre El número de elementos es mayor que 0.
+ */
+Graph* Graph_New( int size, eGraphType type )
+{
+   assert( size > 0 );
+
+   Graph* g = (Graph*) malloc( sizeof( Graph ) );
+   if( g )
+   {
+      g->size = size;
+      g->len = 0;
+      g->type = type;
+
+      g->dedup = eGraphDedup_EAGER;
+      g->in_neighbors = NULL;
+      g->condensation = NULL;
+
+      g->vertices = (Vertex*) calloc( size, sizeof( Vertex ) );
+      STATS_ALLOC( size * sizeof( Vertex ) );
+      g->index = IntMap_New( size );
+      g->edges = EdgeSet_New( size );
+      g->pool = NodePool_New( 0 );
+      TraversalContext_Init( &g->ctx );
+      bool ctx_ok = ctx_reserve( &g->ctx, size );
+
+      if( !g->vertices || !g->index || !g->edges || !g->pool || !ctx_ok )
+      {
+         TraversalContext_Destroy( &g->ctx );
+         free( g->vertices );
+         if( g->index ) IntMap_Delete( &g->index );
+         if( g->edges ) EdgeSet_Delete( &g->edges );
+         if( g->pool ) NodePool_Delete( &g->pool );
+         free( g );
+         g = NULL;
+      }
+   }
+
+   return g;
+   // el cliente es responsable de verificar que el grafo se haya creado correctamente
+}
+
+void Graph_Delete( Graph** g )
+{
+   assert( *g );
+
+   Graph* graph = *g;
+   // para simplificar la notación
+
+   for( int i = 0; i < graph->len; ++i )
+   {
+      list_destroy( &graph->vertices[ i ].neighbors );
+      if( graph->in_neighbors ) list_destroy( &graph->in_neighbors[ i ] );
+   }
+   free( graph->in_neighbors );
+   // los nodos de todas las listas se liberan de golpe junto con la arena
+   NodePool_Delete( &graph->pool );
+
+   IntMap_Delete( &graph->index );
+   TraversalContext_Destroy( &graph->ctx );
+   if( graph->condensation ) Graph_Delete( &graph->condensation );
+   if( graph->edges ) EdgeSet_Delete( &graph->edges );
+   free( graph->vertices );
+   free( graph );
+   *g = NULL;
+}
+
+/**
+ * @brief Garantiza que haya lugar para |capacity| vértices sin volver a pedir memoria.
+ *
+ * Los vértices se guardan por índice, así que las listas de vecinos siguen siendo válidas después
+ * de mover el arreglo; los apuntadores a vértices (Graph_GetVertexByIndex(), NeighborIter) no.
+ *
+ * @param g        El grafo.
+ * @param capacity Número de vértices.
+ *
+ * @return false si se agotó la memoria (el grafo queda sin cambios); true en caso contrario.
+ */
+bool Graph_Reserve( Graph* g, int capacity )
+{
+   if( capacity <= g->size ) return true;
+
+   Vertex* vertices = (Vertex*) realloc( g->vertices, capacity * sizeof( Vertex ) );
+   if( !vertices ) return false;
+   g->vertices = vertices;
+   STATS_ALLOC( capacity * sizeof( Vertex ) );
+
+   if( g->in_neighbors )
+   {
+      NeighborList* in = (NeighborList*) realloc( g->in_neighbors, capacity * sizeof( NeighborList ) );
+      if( !in ) return false;
+      g->in_neighbors = in;
+      STATS_ALLOC( capacity * sizeof( NeighborList ) );
+   }
+
+   if( !ctx_reserve( &g->ctx, capacity ) ) return false;
+   // el arreglo de vértices puede quedar más grande que |size|; no importa
+
+   g->size = capacity;
+   return true;
+}
+
+/**
+ * @brief Libera la capacidad que sobra después del último vértice.
+ *
+ * @param g El grafo.
+ */
+void Graph_ShrinkToFit( Graph* g )
+{
+   int capacity = g->len > 0 ? g->len : 1;
+   if( capacity >= g->size ) return;
+
+   Vertex* vertices = (Vertex*) realloc( g->vertices, capacity * sizeof( Vertex ) );
+   if( vertices ) g->vertices = vertices;
+   else return;
+
+   if( g->in_neighbors ) shrink_array( (void**) &g->in_neighbors, capacity, sizeof( NeighborList ) );
+
+   ctx_shrink( &g->ctx, capacity );
+   g->size = capacity;
+}
+
+/**
+ * @brief Imprime un reporte del grafo
+ *
+ * @param g     El grafo.
+ * @param depth Cuán detallado deberá ser el reporte (0: lo mínimo)
+ */
+void Graph_Print( Graph* g, int depth )
+{
+   for( int i = 0; i < g->len; ++i )
+   {
+      Vertex* vertex = &g->vertices[ i ];
+      // para simplificar la notación.
+
+      printf( "[%d]%d=>", i, vertex->data );
+      NeighborIter it;
+      for( NeighborIter_Start( &it, vertex );
+           ! NeighborIter_End( &it );
+           NeighborIter_Next( &it ) )
+      {
+
+         Data d = NeighborIter_Get( &it );
+         int neighbor_idx = d.index;
+
+         printf( "%d->", g->vertices[ neighbor_idx ].data );
+      }
+      printf( "Nil\n" );
+
+   }
+   printf( "\n" );
+}
+
+/**
+ * @brief Crea un vértice a partir de los datos reales.
+ *
+ * @param g     El grafo.
+ * @param data  Es la información.
+ *
+ * @note Si ya existe un vértice con la misma llave, las búsquedas por llave seguirán encontrando
+ * al primero.
+ *
+ * @note Cuando ya no hay lugar la capacidad se duplica (ver Graph_Reserve()).
+ *
+ * @return false si se agotó la memoria (el vértice no se agregó); true en caso contrario.
+ */
+bool Graph_AddVertex( Graph* g, int data )
+{
+   if( g->len == g->size && !Graph_Reserve( g, 2 * g->size ) ) return false;
+   // la capacidad se duplica, así que el costo por vértice es O(1) amortizado
+
+   Vertex* vertex = &g->vertices[ g->len ];
+   // para simplificar la notación
+
+   invalidate_cache( g );
+
+   vertex->data      = data;
+   vertex->index     = g->len;
+   vertex->state     = &g->ctx.state;
+   vertex->out_degree = 0;
+   vertex->in_degree = 0;
+   list_init( &vertex->neighbors );
+   if( g->in_neighbors ) list_init( &g->in_neighbors[ g->len ] );
+
+   if( !IntMap_Insert( g->index, data, g->len ) && find( g, data ) == -1 ) return false;
+   // IntMap_Insert() también falla si la llave ya existía; eso no es un error
+
+   ++g->len;
+   return true;
+}
+
+int Graph_GetSize( Graph* g )
+{
+   return g->size;
+}
+
+
+/**
+ * @brief Inserta una relación de adyacencia del vértice |start| hacia el vértice |finish|.
+ *
+ * @param g      El grafo.
+ * @param start  Vértice de salida (el dato)
+ * @param finish Vertice de llegada (el dato)
+ *
+ * @return false si uno o ambos vértices no existen; true si la relación se creó con éxito.
+ *
+ * @pre El grafo no puede estar vacío.
+ */
+bool Graph_AddEdge( Graph* g, int start, int finish )
+{
+   assert( g->len > 0 );
+
+   STATS_PHASE_BEGIN( t );
+
+   // obtenemos los índices correspondientes:
+   int start_idx = find( g, start );
+   int finish_idx = find( g, finish );
+
+   TRACE_D( "AddEdge(): from:%d (with index:%d), to:%d (with index:%d)\n", start, start_idx, finish, finish_idx );
+
+   if( start_idx == -1 || finish_idx == -1 )
+   {
+      STATS_PHASE_END( eStatsPhase_BUILD, t );
+      return false;
+   }
+   // uno o ambos vértices no existen
+
+   insert( g, start_idx, finish_idx, 0.0 );
+   // insertamos la arista start-finish
+
+   if( g->type == eGraphType_UNDIRECTED ) insert( g, finish_idx, start_idx, 0.0 );
+   // si el grafo no es dirigido, entonces insertamos la arista finish-start
+
+   STATS_PHASE_END( eStatsPhase_BUILD, t );
+   return true;
+}
+
+
+/**
+ * @brief Una arista de un lote, ya con los índices de sus vértices.
+ */
+typedef struct
+{
+   uint32_t src;
+   uint32_t dst;
+   float w;
+} BulkEdge;
+
+#define RADIX_BITS 11
+#define RADIX_SIZE ( 1 << RADIX_BITS )
+
+// ordena por (src, dst) con un radix sort LSD (estable, así que entre aristas repetidas la primera
+// del lote queda primero); |bits| es el número de bits que hacen falta para el índice más grande.
+//
+// ret: el arreglo ordenado (|edges| o |tmp|)
+static BulkEdge* radix_sort_edges( BulkEdge* edges, BulkEdge* tmp, size_t n, int bits )
+{
+   size_t count[ RADIX_SIZE ];
+
+   for( int pass = 0; pass < 2; ++pass )
+   {
+      // primero el destino (la llave menos significativa) y luego el origen
+      for( int shift = 0; shift < bits; shift += RADIX_BITS )
+      {
+         memset( count, 0, sizeof( count ) );
+
+         for( size_t i = 0; i < n; ++i )
+         {
+            uint32_t key = pass == 0 ? edges[ i ].dst : edges[ i ].src;
+            ++count[ ( key >> shift ) & ( RADIX_SIZE - 1 ) ];
+         }
+
+         size_t sum = 0;
+         for( int d = 0; d < RADIX_SIZE; ++d )
+         {
+            size_t c = count[ d ];
+            count[ d ] = sum;
+            sum += c;
+         }
+
+         for( size_t i = 0; i < n; ++i )
+         {
+            uint32_t key = pass == 0 ? edges[ i ].dst : edges[ i ].src;
+            tmp[ count[ ( key >> shift ) & ( RADIX_SIZE - 1 ) ]++ ] = edges[ i ];
+         }
+
+         BulkEdge* swap = edges;
+         edges = tmp;
+         tmp = swap;
+      }
+   }
+
+   return edges;
+}
+
+// implementa Graph_AddEdges(); la función pública sólo agrega la medición del tiempo
+static bool add_edges( Graph* g, const int* src, const int* dst, const float* w, size_t n )
+{
+   TRACE_I( "AddEdges(): %zu edges\n", n );
+
+   if( n == 0 ) return true;
+
+   bool undirected = g->type == eGraphType_UNDIRECTED;
+   size_t total = undirected ? 2 * n : n;
+
+   BulkEdge* edges = (BulkEdge*) malloc( total * sizeof( BulkEdge ) );
+   BulkEdge* tmp = (BulkEdge*) malloc( total * sizeof( BulkEdge ) );
+   if( !edges || !tmp )
+   {
+      free( edges );
+      free( tmp );
+      return false;
+   }
+
+   size_t len = 0;
+   for( size_t i = 0; i < n; ++i )
+   {
+      int start_idx = find( g, src[ i ] );
+      int finish_idx = find( g, dst[ i ] );
+
+      if( start_idx == -1 || finish_idx == -1 )
+      {
+         free( edges );
+         free( tmp );
+         return false;
+      }
+
+      float weigth = w ? w[ i ] : 0.0;
+
+      edges[ len++ ] = (BulkEdge){ .src = start_idx, .dst = finish_idx, .w = weigth };
+      if( undirected ) edges[ len++ ] = (BulkEdge){ .src = finish_idx, .dst = start_idx, .w = weigth };
+   }
+
+   int bits = 1;
+   while( bits < 31 && ( 1u << bits ) < (unsigned) g->len ) ++bits;
+
+   BulkEdge* sorted = radix_sort_edges( edges, tmp, len, bits );
+
+   for( size_t i = 0; i < len; )
+   {
+      int vertex_idx = sorted[ i ].src;
+      Vertex* vertex = &g->vertices[ vertex_idx ];
+
+      size_t end = i;
+      while( end < len && sorted[ end ].src == sorted[ i ].src ) ++end;
+
+#if VERTEX_USE_SMALLVEC
+      DataVec_Reserve( &vertex->neighbors, DataVec_Len( &vertex->neighbors ) + (int) ( end - i ) );
+#endif
+
+      for( size_t j = i; j < end; ++j )
+      {
+         if( j > i && sorted[ j ].dst == sorted[ j - 1 ].dst )
+         {
+            STATS_ADD( duplicate_edges, 1 );
+            continue;
+         }
+         // duplicado dentro del lote
+
+         if( is_new_edge( g, vertex_idx, sorted[ j ].dst ) )
+         {
+            push_neighbor( g, vertex, sorted[ j ].dst, sorted[ j ].w );
+         }
+      }
+
+      i = end;
+   }
+
+   free( edges );
+   free( tmp );
+   return true;
+}
+
+/**
+ * @brief Inserta un lote de aristas |src[ i ]| -> |dst[ i ]| con peso |w[ i ]|.
+ *
+ * Es equivalente a llamar a Graph_AddEdge() por cada arista, pero las llaves se traducen a
+ * índices de una sola vez, las aristas se ordenan por (origen, destino) con un radix sort y los
+ * duplicados se descartan con una sola pasada lineal. En un grafo no dirigido cada arista se
+ * agrega en ambos sentidos.
+ *
+ * Dentro de un lote los vecinos nuevos de cada vértice se agregan en orden ascendente de índice
+ * (no en el orden del lote); de cada grupo de aristas repetidas se conserva el peso de la primera.
+ *
+ * @param g   El grafo.
+ * @param src Vértices de salida (los datos).
+ * @param dst Vértices de llegada (los datos).
+ * @param w   Los pesos; puede ser NULL (todos los pesos son 0).
+ * @param n   Número de aristas.
+ *
+ * @return false si algún vértice no existe o si se agotó la memoria (en ambos casos el grafo queda
+ * sin cambios); true si las aristas se agregaron con éxito.
+ */
+bool Graph_AddEdges( Graph* g, const int* src, const int* dst, const float* w, size_t n )
+{
+   STATS_PHASE_BEGIN( t );
+   bool ret = add_edges( g, src, dst, w, n );
+   STATS_PHASE_END( eStatsPhase_BUILD, t );
+
+   return ret;
+}
+
+
+int Graph_GetLen( const Graph* g )
+{
+   return g->len;
+}
+
+typedef struct
+{
+   int index; ///< índice del vecino
+   int pos;   ///< posición en la lista de vecinos
+} DedupEntry;
+
+static int cmp_dedup_entry( const void* a, const void* b )
+{
+   const DedupEntry* x = (const DedupEntry*) a;
+   const DedupEntry* y = (const DedupEntry*) b;
+
+   if( x->index != y->index ) return x->index < y->index ? -1 : 1;
+   return x->pos < y->pos ? -1 : ( x->pos > y->pos );
+}
+
+// quita de |list| las repeticiones de cada vecino (se conserva la primera) y devuelve cuántas
+// quitó; al regresar, |entries| está ordenado por vecino y |drop| marca las posiciones quitadas
+static int dedup_list( NeighborList* list, DedupEntry* entries, bool* drop )
+{
+   int degree = 0;
+   for( NeighborPos pos = list_begin( list ); !list_end( list, pos ); pos = neighbors_next( pos ) )
+   {
+      entries[ degree ].index = neighbors_get( pos ).index;
+      entries[ degree ].pos = degree;
+      drop[ degree ] = false;
+      ++degree;
+   }
+
+   qsort( entries, degree, sizeof( DedupEntry ), cmp_dedup_entry );
+
+   int removed = 0;
+   for( int j = 1; j < degree; ++j )
+   {
+      if( entries[ j ].index == entries[ j - 1 ].index )
+      {
+         drop[ entries[ j ].pos ] = true;
+         ++removed;
+      }
+   }
+
+   if( removed == 0 ) return 0;
+
+#if VERTEX_USE_SMALLVEC
+   DataVec_Remove_marked( list, drop );
+#else
+   List_Cursor_front( *list );
+   for( int pos = 0; pos < degree; ++pos )
+   {
+      if( drop[ pos ] ) List_Cursor_erase( *list );
+      else              List_Cursor_next( *list );
+   }
+#endif
+
+   return removed;
+}
+
+/**
+ * @brief Elimina las aristas duplicadas con una pasada de ordenamiento por vértice.
+ *
+ * De cada grupo de aristas repetidas se conserva la primera que se insertó, así que el orden de
+ * las listas de vecinos queda igual que si los duplicados se hubieran rechazado al insertar. Si se
+ * mantienen los vecinos de entrada, se depuran de la misma forma (sin reconstruirlos), y sólo
+ * cuando se eliminó alguna arista.
+ *
+ * @param g El grafo.
+ *
+ * @return false si se agotó la memoria (el grafo queda sin cambios); true en caso contrario.
+ */
+bool Graph_Deduplicate( Graph* g )
+{
+   int max_degree = 0;
+   for( int i = 0; i < g->len; ++i )
+   {
+      int degree = neighbors_len( &g->vertices[ i ] );
+      if( g->in_neighbors && g->vertices[ i ].in_degree > degree ) degree = g->vertices[ i ].in_degree;
+
+      if( degree > max_degree ) max_degree = degree;
+   }
+
+   if( max_degree < 2 ) return true;
+
+   DedupEntry* entries = (DedupEntry*) malloc( max_degree * sizeof( DedupEntry ) );
+   bool* drop = (bool*) malloc( max_degree * sizeof( bool ) );
+   if( !entries || !drop )
+   {
+      free( entries );
+      free( drop );
+      return false;
+   }
+   // de aquí en adelante ya no se pide memoria, así que no hay forma de fallar a medias
+
+   bool any = false;
+   for( int i = 0; i < g->len; ++i )
+   {
+      Vertex* vertex = &g->vertices[ i ];
+
+      int degree = vertex->out_degree;
+      int removed = dedup_list( &vertex->neighbors, entries, drop );
+      if( removed == 0 ) continue;
+
+      vertex->out_degree -= removed;
+      for( int j = 0; j < degree; ++j )
+      {
+         if( drop[ entries[ j ].pos ] ) --g->vertices[ entries[ j ].index ].in_degree;
+      }
+
+      any = true;
+   }
+
+   if( any )
+   {
+      invalidate_cache( g );
+
+      // cada lista de entrada tiene las mismas repeticiones, en el mismo orden de inserción, así
+      // que conservar la primera deja el mismo peso que en la lista de salida
+      if( g->in_neighbors )
+      {
+         for( int i = 0; i < g->len; ++i ) dedup_list( &g->in_neighbors[ i ], entries, drop );
+      }
+   }
+
+   free( drop );
+   free( entries );
+
+   return true;
+}
+
+/**
+ * @brief Cambia el momento en que se rechazan las aristas duplicadas.
+ *
+ * En modo eGraphDedup_DEFERRED las aristas se insertan sin verificar si ya existían, lo cual
+ * conviene para cargas masivas. Al regresar a eGraphDedup_EAGER se eliminan los duplicados (ver
+ * Graph_Deduplicate()) y se reconstruye el conjunto de aristas.
+ *
+ * @param g    El grafo.
+ * @param mode El nuevo modo.
+ *
+ * @return false si se agotó la memoria (el modo no cambia); true en caso contrario.
+ */
+bool Graph_SetDedup( Graph* g, eGraphDedup mode )
+{
+   if( mode == g->dedup ) return true;
+
+   if( mode == eGraphDedup_DEFERRED )
+   {
+      EdgeSet_Delete( &g->edges );
+      g->dedup = mode;
+      return true;
+   }
+
+   if( !Graph_Deduplicate( g ) ) return false;
+
+   size_t edges = 0;
+   for( int i = 0; i < g->len; ++i )
+   {
+      edges += neighbors_len( &g->vertices[ i ] );
+   }
+
+   g->edges = EdgeSet_New( edges );
+   if( !g->edges ) return false;
+
+   for( int i = 0; i < g->len; ++i )
+   {
+      const Vertex* vertex = &g->vertices[ i ];
+
+      NeighborIter it;
+      for( NeighborIter_Start( &it, vertex ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         EdgeSet_Insert( g->edges, i, NeighborIter_Get( &it ).index );
+      }
+   }
+
+   g->dedup = mode;
+   return true;
+}
+
+
+/**
+ * @brief Activa o desactiva la lista de vecinos de entrada (la adyacencia inversa) de cada vértice.
+ *
+ * Al activarla se construye con una sola pasada sobre las aristas; a partir de ahí cada arista
+ * nueva se registra en ambas listas. Sirve para consultas hacia atrás (predecesores, quién llega a
+ * un vértice) sin recorrer todas las listas de vecinos; ver NeighborIter_StartIn().
+ *
+ * En un grafo no dirigido no hace nada: los vecinos de entrada son los de salida.
+ *
+ * @param g      El grafo.
+ * @param enable true para mantener los vecinos de entrada; false para liberarlos.
+ *
+ * @return false si se agotó la memoria (siguen desactivados); true en caso contrario.
+ *
+ * @note Con VERTEX_USE_SMALLVEC=0 los nodos de las listas liberadas no regresan al sistema: vuelven
+ * a la arena del grafo, donde los reutilizan las listas que crecen después, y se liberan hasta que
+ * se destruye el grafo.
+ */
+bool Graph_SetReverse( Graph* g, bool enable )
+{
+   if( g->type == eGraphType_UNDIRECTED || enable == ( g->in_neighbors != NULL ) ) return true;
+
+   if( !enable )
+   {
+      for( int i = 0; i < g->len; ++i ) list_free( &g->in_neighbors[ i ] );
+      free( g->in_neighbors );
+      g->in_neighbors = NULL;
+      return true;
+   }
+
+   NeighborList* in = (NeighborList*) malloc( g->size * sizeof( NeighborList ) );
+   if( !in ) return false;
+   STATS_ALLOC( g->size * sizeof( NeighborList ) );
+
+   for( int i = 0; i < g->len; ++i )
+   {
+      list_init( &in[ i ] );
+#if VERTEX_USE_SMALLVEC
+      if( !DataVec_Reserve( &in[ i ], g->vertices[ i ].in_degree ) )
+      {
+         for( int j = 0; j <= i; ++j ) list_destroy( &in[ j ] );
+         free( in );
+         return false;
+      }
+#endif
+   }
+
+   for( int i = 0; i < g->len; ++i )
+   {
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &g->vertices[ i ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         Data d = NeighborIter_Get( &it );
+         list_push( g, &in[ d.index ], i, d.weight );
+      }
+   }
+   // los vecinos de entrada de cada vértice quedan en orden ascendente de índice
+
+   g->in_neighbors = in;
+   return true;
+}
+
+/**
+ * @brief Indica si se pueden recorrer los vecinos de entrada con NeighborIter_StartIn().
+ */
+bool Graph_HasReverse( const Graph* g )
+{
+   return g->type == eGraphType_UNDIRECTED || g->in_neighbors;
+}
+
+/**
+ * @brief Devuelve el número de aristas que llegan al vértice. O(1), aunque no se mantengan los
+ * vecinos de entrada.
+ *
+ * @param g          El grafo.
+ * @param vertex_idx Índice del vértice.
+ */
+int Graph_InDegree( const Graph* g, int vertex_idx )
+{
+   assert( 0 <= vertex_idx && vertex_idx < g->len );
+
+   return g->vertices[ vertex_idx ].in_degree;
+}
+
+/**
+ * @brief Coloca al iterador en el primer vecino de entrada del vértice: cada elemento tiene el
+ * índice del vértice de origen y el peso de la arista. Se avanza con NeighborIter_Next() y
+ * NeighborIter_End(), igual que con los vecinos de salida.
+ *
+ * @param it         El iterador.
+ * @param g          El grafo.
+ * @param vertex_idx Índice del vértice.
+ *
+ * @pre Graph_HasReverse( g )
+ */
+void NeighborIter_StartIn( NeighborIter* it, const Graph* g, int vertex_idx )
+{
+   assert( it );
+   assert( Graph_HasReverse( g ) );
+   assert( 0 <= vertex_idx && vertex_idx < g->len );
+
+   it->list = g->in_neighbors ? &g->in_neighbors[ vertex_idx ] : &g->vertices[ vertex_idx ].neighbors;
+   it->pos = list_begin( it->list );
+}
+
+
+/**
+ * @brief Devuelve la información asociada al vértice indicado.
+ *
+ * @param g          Un grafo.
+ * @param vertex_idx El índice del vértice del cual queremos conocer su información.
+ *
+ * @return La información asociada al vértice vertex_idx.
+ */
+Item Graph_GetDataByIndex( const Graph* g, int vertex_idx )
+{
+   assert( 0 <= vertex_idx && vertex_idx < g->len );
+
+   return g->vertices[ vertex_idx ].data;
+}
+
+/**
+ * @brief Devuelve una referencia al vértice indicado.
+ *
+ * Esta función puede ser utilizada con las operaciones @see Vertex_Start(), @see Vertex_End(), @see Vertex_Next().
+ *
+ * @param g          Un grafo
+ * @param vertex_idx El índice del vértice del cual queremos devolver la referencia.
+ *
+ * @return La referencia al vértice vertex_idx.
+ */
+Vertex* Graph_GetVertexByIndex( const Graph* g, int vertex_idx )
+{
+   assert( 0 <= vertex_idx && vertex_idx < g->len );
+
+   return &(g->vertices[ vertex_idx ] );
+}
+
+/**
+ * @brief Devuelve una referencia al vértice indicado.
+ *
+ * Esta función puede ser utilizada con las operaciones @see Vertex_Start(), @see Vertex_End(), @see Vertex_Next().
+ *
+ * @param g   Un grafo
+ * @param key Llave de búsqueda (esto es, el |dato|) del vértice del cual queremos devolver la referencia.
+ *
+ * @return La referencia al vértice que coincida con key (esto es, con el |dato|).
+ */
+Vertex* Graph_GetVertexByKey( const Graph* g, Item key )
+{
+   int idx = find( g, key );
+
+   return idx != -1 ? &(g->vertices[ idx ]) : NULL;
+}
+
+int Graph_Size( Graph* g )
+{
+   return g->size;
+}
+
+
+//----------------------------------------------------------------------
+//                     Frozen (CSR) graph stuff:
+//----------------------------------------------------------------------
+
+// implementa Graph_Freeze(); la función pública sólo agrega la medición del tiempo
+static FrozenGraph* freeze( const Graph* g )
+{
+   FrozenGraph* fg = (FrozenGraph*) malloc( sizeof( FrozenGraph ) );
+   if( !fg ) return NULL;
+
+   fg->len = g->len;
+   fg->type = g->type;
+   fg->map = NULL;
+   fg->map_len = 0;
+
+   fg->offsets = (int*) malloc( ( g->len + 1 ) * sizeof( int ) );
+   fg->keys = (Item*) malloc( ( g->len > 0 ? g->len : 1 ) * sizeof( Item ) );
+   if( !fg->offsets || !fg->keys )
+   {
+      free( fg->offsets );
+      free( fg->keys );
+      free( fg );
+      return NULL;
+   }
+
+   // primera pasada: contamos los vecinos de cada vértice
+   int edges = 0;
+   for( int i = 0; i < g->len; ++i )
+   {
+      const Vertex* vertex = &g->vertices[ i ];
+
+      fg->offsets[ i ] = edges;
+      fg->keys[ i ] = vertex->data;
+
+      edges += neighbors_len( vertex );
+   }
+   fg->offsets[ g->len ] = edges;
+   fg->edges = edges;
+
+   fg->targets = (int*) malloc( ( edges > 0 ? edges : 1 ) * sizeof( int ) );
+   fg->weights = (float*) malloc( ( edges > 0 ? edges : 1 ) * sizeof( float ) );
+   if( !fg->targets || !fg->weights )
+   {
+      free( fg->targets );
+      free( fg->weights );
+      free( fg->offsets );
+      free( fg->keys );
+      free( fg );
+      return NULL;
+   }
+
+   // segunda pasada: copiamos las aristas
+   for( int i = 0; i < g->len; ++i )
+   {
+      const Vertex* vertex = &g->vertices[ i ];
+      int pos = fg->offsets[ i ];
+
+      NeighborIter it;
+      for( NeighborIter_Start( &it, vertex ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         Data d = NeighborIter_Get( &it );
+
+         fg->targets[ pos ] = d.index;
+         fg->weights[ pos ] = d.weight;
+         ++pos;
+      }
+   }
+
+   return fg;
+}
+
+/**
+ * @brief Construye la representación CSR del grafo.
+ *
+ * @param g El grafo. No se modifica (ni siquiera los cursores de las listas de vecinos).
+ *
+ * @return Un nuevo grafo congelado, o NULL si se agotó la memoria.
+ *
+ * @post Los cambios posteriores a |g| no se ven reflejados en la fotografía.
+ */
+FrozenGraph* Graph_Freeze( const Graph* g )
+{
+   STATS_PHASE_BEGIN( t );
+   FrozenGraph* ret = freeze( g );
+   STATS_PHASE_END( eStatsPhase_FREEZE, t );
+
+   return ret;
+}
+
+void FrozenGraph_Delete( FrozenGraph** fg )
+{
+   assert( *fg );
+
+   if( (*fg)->map )
+   {
+      munmap( (*fg)->map, (*fg)->map_len );
+   }
+   else
+   {
+      free( (*fg)->offsets );
+      free( (*fg)->targets );
+      free( (*fg)->weights );
+      free( (*fg)->keys );
+   }
+   free( *fg );
+   *fg = NULL;
+}
+
+int FrozenGraph_GetLen( const FrozenGraph* fg )
+{
+   return fg->len;
+}
+
+Item FrozenGraph_GetDataByIndex( const FrozenGraph* fg, int vertex_idx )
+{
+   assert( 0 <= vertex_idx && vertex_idx < fg->len );
+
+   return fg->keys[ vertex_idx ];
+}
+
+int FrozenGraph_Degree( const FrozenGraph* fg, int vertex_idx )
+{
+   assert( 0 <= vertex_idx && vertex_idx < fg->len );
+
+   return fg->offsets[ vertex_idx + 1 ] - fg->offsets[ vertex_idx ];
+}
+
+/**
+ * @brief Construye el grafo transpuesto: las mismas aristas (y pesos) con el sentido invertido.
+ *
+ * Los vecinos de i en la transpuesta son los vértices de los que sale una arista hacia i, en
+ * orden ascendente de índice; así FrozenGraph_Degree() sobre la transpuesta da el grado de
+ * entrada, y cualquier recorrido sobre ella es un recorrido hacia atrás en |fg|.
+ *
+ * @param fg El grafo congelado.
+ *
+ * @return Un nuevo grafo congelado, o NULL si se agotó la memoria.
+ */
+FrozenGraph* FrozenGraph_Transpose( const FrozenGraph* fg )
+{
+   FrozenGraph* t = (FrozenGraph*) malloc( sizeof( FrozenGraph ) );
+   if( !t ) return NULL;
+
+   t->len = fg->len;
+   t->edges = fg->edges;
+   t->type = fg->type;
+   t->map = NULL;
+   t->map_len = 0;
+
+   t->offsets = (int*) calloc( fg->len + 1, sizeof( int ) );
+   t->keys = (Item*) malloc( ( fg->len > 0 ? fg->len : 1 ) * sizeof( Item ) );
+   t->targets = (int*) malloc( ( fg->edges > 0 ? fg->edges : 1 ) * sizeof( int ) );
+   t->weights = (float*) malloc( ( fg->edges > 0 ? fg->edges : 1 ) * sizeof( float ) );
+   if( !t->offsets || !t->keys || !t->targets || !t->weights )
+   {
+      free( t->offsets );
+      free( t->keys );
+      free( t->targets );
+      free( t->weights );
+      free( t );
+      return NULL;
+   }
+
+   memcpy( t->keys, fg->keys, fg->len * sizeof( Item ) );
+
+   // conteo: offsets[ w + 1 ] = aristas que llegan a w
+   for( int pos = 0; pos < fg->edges; ++pos ) ++t->offsets[ fg->targets[ pos ] + 1 ];
+   for( int i = 0; i < fg->len; ++i ) t->offsets[ i + 1 ] += t->offsets[ i ];
+
+   // reparto: al terminar, offsets[ w ] apunta al final del tramo de w (el inicio del de w + 1)
+   for( int v = 0; v < fg->len; ++v )
+   {
+      for( int pos = fg->offsets[ v ]; pos < fg->offsets[ v + 1 ]; ++pos )
+      {
+         int at = t->offsets[ fg->targets[ pos ] ]++;
+         t->targets[ at ] = v;
+         t->weights[ at ] = fg->weights ? fg->weights[ pos ] : 0.0;
+      }
+   }
+
+   for( int i = fg->len; i > 0; --i ) t->offsets[ i ] = t->offsets[ i - 1 ];
+   t->offsets[ 0 ] = 0;
+
+   return t;
+}
+
+/**
+ * @brief Recorrido en profundidad sobre el grafo congelado a partir del vértice |start|.
+ *
+ * Produce los mismos tiempos, predecesores y orden posterior que dfs_topol(), pero usa una pila
+ * explícita y recorre arreglos contiguos en lugar de listas ligadas.
+ *
+ * @param fg         El grafo congelado.
+ * @param start      Índice del vértice de inicio.
+ * @param pred       Predecesor (índice) de cada vértice; -1 si no tiene. Puede ser NULL.
+ * @param discovery  Tiempo de descubrimiento de cada vértice; 0 si no se alcanzó. Puede ser NULL.
+ * @param finish     Tiempo de finalización de cada vértice; 0 si no se alcanzó. Puede ser NULL.
+ * @param post_order Índices de los vértices en el orden en que terminaron. Puede ser NULL.
+ *
+ * @return El número de vértices alcanzados, o -1 si se agotó la memoria.
+ *
+ * @pre Los arreglos no nulos tienen al menos FrozenGraph_GetLen() elementos.
+ */
+int FrozenGraph_Dfs( const FrozenGraph* fg, int start, int* pred, int* discovery, int* finish, int* post_order )
+{
+   assert( 0 <= start && start < fg->len );
+
+   uint8_t* color = (uint8_t*) calloc( fg->len, sizeof( uint8_t ) );
+   int* stack = (int*) malloc( 2 * fg->len * sizeof( int ) );
+   // cada marco de la pila ocupa dos enteros: el vértice y la siguiente arista por revisar
+   if( !color || !stack )
+   {
+      free( color );
+      free( stack );
+      return -1;
+   }
+
+   for( int i = 0; i < fg->len; ++i )
+   {
+      if( pred ) pred[ i ] = -1;
+      if( discovery ) discovery[ i ] = 0;
+      if( finish ) finish[ i ] = 0;
+   }
+
+   int time_ = 0;
+   int visited = 0;
+   int top = 0;
+
+   color[ start ] = GRAY;
+   if( discovery ) discovery[ start ] = ++time_;
+   stack[ 0 ] = start;
+   stack[ 1 ] = fg->offsets[ start ];
+   top = 1;
+
+   while( top > 0 )
+   {
+      int v = stack[ 2 * ( top - 1 ) ];
+      int pos = stack[ 2 * ( top - 1 ) + 1 ];
+      int end = fg->offsets[ v + 1 ];
+
+      while( pos < end && color[ fg->targets[ pos ] ] != WHITE ) ++pos;
+
+      if( pos < end )
+      {
+         int w = fg->targets[ pos ];
+         stack[ 2 * ( top - 1 ) + 1 ] = pos + 1;
+
+         color[ w ] = GRAY;
+         if( pred ) pred[ w ] = v;
+         if( discovery ) discovery[ w ] = ++time_;
+
+         stack[ 2 * top ] = w;
+         stack[ 2 * top + 1 ] = fg->offsets[ w ];
+         ++top;
+      }
+      else
+      {
+         color[ v ] = BLACK;
+         ++time_;
+         if( finish ) finish[ v ] = time_;
+         if( post_order ) post_order[ visited ] = v;
+         ++visited;
+         --top;
+      }
+   }
+
+   free( stack );
+   free( color );
+   return visited;
+}
+
+/**
+ * @brief Recorrido en amplitud sobre el grafo congelado a partir del vértice |start|.
+ *
+ * @param fg       El grafo congelado.
+ * @param start    Índice del vértice de inicio.
+ * @param distance Número de aristas desde |start|; -1 si no se alcanzó. Puede ser NULL.
+ * @param pred     Predecesor (índice) de cada vértice; -1 si no tiene. Puede ser NULL.
+ * @param order    Índices de los vértices en el orden en que fueron descubiertos. Puede ser NULL.
+ *
+ * @return El número de vértices alcanzados, o -1 si se agotó la memoria.
+ *
+ * @pre Los arreglos no nulos tienen al menos FrozenGraph_GetLen() elementos.
+ */
+int FrozenGraph_Bfs( const FrozenGraph* fg, int start, int* distance, int* pred, int* order )
+{
+   assert( 0 <= start && start < fg->len );
+
+   uint8_t* color = (uint8_t*) calloc( fg->len, sizeof( uint8_t ) );
+   int* queue = order ? order : (int*) malloc( fg->len * sizeof( int ) );
+   // cada vértice entra a lo más una vez a la cola, así que |order| sirve como cola
+   if( !color || !queue )
+   {
+      free( color );
+      if( queue != order ) free( queue );
+      return -1;
+   }
+
+   for( int i = 0; i < fg->len; ++i )
+   {
+      if( distance ) distance[ i ] = -1;
+      if( pred ) pred[ i ] = -1;
+   }
+
+   int front = 0;
+   int back = 0;
+
+   color[ start ] = GRAY;
+   if( distance ) distance[ start ] = 0;
+   queue[ back++ ] = start;
+
+   while( front < back )
+   {
+      int v = queue[ front++ ];
+
+      for( int pos = fg->offsets[ v ]; pos < fg->offsets[ v + 1 ]; ++pos )
+      {
+         int w = fg->targets[ pos ];
+
+         if( color[ w ] == WHITE )
+         {
+            color[ w ] = GRAY;
+            if( distance ) distance[ w ] = distance[ v ] + 1;
+            if( pred ) pred[ w ] = v;
+            queue[ back++ ] = w;
+         }
+      }
+      color[ v ] = BLACK;
+   }
+
+   if( queue != order ) free( queue );
+   free( color );
+   return back;
+}
+
+/**
+ * @brief Ordenamiento topológico de los vértices alcanzables desde |start|.
+ *
+ * @param fg    El grafo congelado.
+ * @param start Índice del vértice de inicio.
+ * @param order Índices de los vértices en orden topológico (el inverso del orden posterior de la
+ * búsqueda en profundidad).
+ *
+ * @return El número de vértices en |order|, o -1 si se agotó la memoria.
+ *
+ * @pre |order| tiene al menos FrozenGraph_GetLen() elementos.
+ * @note Al igual que dfs_topol(), no detecta ciclos.
+ */
+int FrozenGraph_DfsTopol( const FrozenGraph* fg, int start, int* order )
+{
+   int n = FrozenGraph_Dfs( fg, start, NULL, NULL, NULL, order );
+
+   for( int i = 0, j = n - 1; i < j; ++i, --j )
+   {
+      int tmp = order[ i ];
+      order[ i ] = order[ j ];
+      order[ j ] = tmp;
+   }
+
+   return n;
+}
+
+
+//----------------------------------------------------------------------
+//                     Binary snapshot stuff:
+//----------------------------------------------------------------------
+
+/*
+ * Formato del archivo (versión 1). Todos los enteros están en little-endian y cada sección
+ * empieza en un múltiplo de 8 bytes, de manera que los arreglos se pueden usar directamente
+ * desde el archivo proyectado en memoria:
+ *
+ *   encabezado (SNAPSHOT_HEADER_SIZE bytes):
+ *      magic[ 8 ]            "GRAFOCSR"
+ *      uint32 version        SNAPSHOT_VERSION
+ *      uint32 flags          SNAPSHOT_FLAG_*
+ *      uint64 len            número de vértices
+ *      uint64 edges          número de aristas
+ *      uint64 keys_at        posición de los datos de los vértices (int32[ len ])
+ *      uint64 offsets_at     posición de los desplazamientos CSR (int32[ len + 1 ])
+ *      uint64 targets_at     posición de los índices de los vecinos (int32[ edges ])
+ *      uint64 weights_at     posición de los pesos (float32[ edges ]); 0 si no hay pesos
+ */
+
+#define SNAPSHOT_MAGIC "GRAFOCSR"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_HEADER_SIZE 64
+
+#define SNAPSHOT_FLAG_WEIGHTS  0x1
+#define SNAPSHOT_FLAG_DIRECTED 0x2
+
+static bool host_is_little_endian()
+{
+   const uint16_t one = 1;
+   return *(const uint8_t*) &one == 1;
+}
+
+static void put_u32( uint8_t* p, uint32_t x )
+{
+   for( int i = 0; i < 4; ++i ) p[ i ] = (uint8_t) ( x >> ( 8 * i ) );
+}
+
+static void put_u64( uint8_t* p, uint64_t x )
+{
+   for( int i = 0; i < 8; ++i ) p[ i ] = (uint8_t) ( x >> ( 8 * i ) );
+}
+
+static uint32_t get_u32( const uint8_t* p )
+{
+   uint32_t x = 0;
+   for( int i = 3; i >= 0; --i ) x = ( x << 8 ) | p[ i ];
+   return x;
+}
+
+static uint64_t get_u64( const uint8_t* p )
+{
+   uint64_t x = 0;
+   for( int i = 7; i >= 0; --i ) x = ( x << 8 ) | p[ i ];
+   return x;
+}
+
+static uint64_t align8( uint64_t x )
+{
+   return ( x + 7 ) & ~(uint64_t) 7;
+}
+
+// escribe |n| elementos de 4 bytes en little-endian seguidos de relleno hasta un múltiplo de 8
+static bool write_section( FILE* f, const void* data, size_t n )
+{
+   bool ok = true;
+
+   if( host_is_little_endian() )
+   {
+      ok = fwrite( data, 4, n, f ) == n;
+   }
+   else
+   {
+      const uint32_t* words = (const uint32_t*) data;
+      for( size_t i = 0; i < n && ok; ++i )
+      {
+         uint8_t le[ 4 ];
+         put_u32( le, words[ i ] );
+         ok = fwrite( le, 1, 4, f ) == 4;
+      }
+   }
+
+   static const uint8_t zeros[ 8 ] = { 0 };
+   size_t pad = align8( 4 * (uint64_t) n ) - 4 * (uint64_t) n;
+   return ok && fwrite( zeros, 1, pad, f ) == pad;
+}
+
+/**
+ * @brief Guarda al grafo congelado en un archivo binario que se puede cargar con Graph_Load().
+ *
+ * @param fg           El grafo congelado.
+ * @param path         Nombre del archivo. Si ya existe se sobreescribe.
+ * @param with_weights Si se guardan los pesos de las aristas.
+ *
+ * @return true si el archivo se escribió completo; false en caso contrario.
+ */
+bool FrozenGraph_Save( const FrozenGraph* fg, const char* path, bool with_weights )
+{
+   with_weights = with_weights && fg->weights;
+
+   uint64_t keys_at    = SNAPSHOT_HEADER_SIZE;
+   uint64_t offsets_at = keys_at + align8( 4 * (uint64_t) fg->len );
+   uint64_t targets_at = offsets_at + align8( 4 * ( (uint64_t) fg->len + 1 ) );
+   uint64_t weights_at = with_weights ? targets_at + align8( 4 * (uint64_t) fg->edges ) : 0;
+
+   uint8_t header[ SNAPSHOT_HEADER_SIZE ] = { 0 };
+   memcpy( header, SNAPSHOT_MAGIC, 8 );
+   put_u32( header + 8, SNAPSHOT_VERSION );
+   put_u32( header + 12, ( with_weights ? SNAPSHOT_FLAG_WEIGHTS : 0 )
+                       | ( fg->type == eGraphType_DIRECTED ? SNAPSHOT_FLAG_DIRECTED : 0 ) );
+   put_u64( header + 16, fg->len );
+   put_u64( header + 24, fg->edges );
+   put_u64( header + 32, keys_at );
+   put_u64( header + 40, offsets_at );
+   put_u64( header + 48, targets_at );
+   put_u64( header + 56, weights_at );
+
+   FILE* f = fopen( path, "wb" );
+   if( !f ) return false;
+
+   bool ok = fwrite( header, 1, SNAPSHOT_HEADER_SIZE, f ) == SNAPSHOT_HEADER_SIZE
+      && write_section( f, fg->keys, fg->len )
+      && write_section( f, fg->offsets, fg->len + 1 )
+      && write_section( f, fg->targets, fg->edges )
+      && ( !with_weights || write_section( f, fg->weights, fg->edges ) );
+
+   return fclose( f ) == 0 && ok;
+}
+
+/**
+ * @brief Guarda al grafo en un archivo binario que se puede cargar con Graph_Load().
+ *
+ * @param g            El grafo.
+ * @param path         Nombre del archivo. Si ya existe se sobreescribe.
+ * @param with_weights Si se guardan los pesos de las aristas.
+ *
+ * @return true si el archivo se escribió completo; false en caso contrario.
+ */
+bool Graph_Save( const Graph* g, const char* path, bool with_weights )
+{
+   FrozenGraph* fg = Graph_Freeze( g );
+   if( !fg ) return false;
+
+   bool ok = FrozenGraph_Save( fg, path, with_weights );
+
+   FrozenGraph_Delete( &fg );
+   return ok;
+}
+
+// indica si la sección [ at, at + bytes ) está alineada y cabe en un archivo de |size| bytes
+static bool section_fits( uint64_t at, uint64_t bytes, uint64_t size )
+{
+   return at % 8 == 0 && at >= SNAPSHOT_HEADER_SIZE && at <= size && bytes <= size - at;
+}
+
+/**
+ * @brief Carga un grafo guardado con Graph_Save() o FrozenGraph_Save().
+ *
+ * El archivo se proyecta en memoria (mmap) y los arreglos del grafo congelado apuntan directamente
+ * a él, sin copiarlos: la carga no depende del tamaño del grafo y varios procesos que carguen el
+ * mismo archivo comparten las mismas páginas del caché del sistema.
+ *
+ * @param path Nombre del archivo.
+ *
+ * @return Un grafo congelado (se libera con FrozenGraph_Delete()), o NULL si el archivo no existe,
+ * no tiene el formato esperado o la máquina no es little-endian.
+ *
+ * @note Sólo se valida el encabezado; para revisar también los índices de las aristas use
+ * FrozenGraph_Validate().
+ */
+FrozenGraph* Graph_Load( const char* path )
+{
+   if( !host_is_little_endian() ) return NULL;
+
+   int fd = open( path, O_RDONLY );
+   if( fd < 0 ) return NULL;
+
+   struct stat st;
+   if( fstat( fd, &st ) != 0 || (uint64_t) st.st_size < SNAPSHOT_HEADER_SIZE )
+   {
+      close( fd );
+      return NULL;
+   }
+
+   size_t size = (size_t) st.st_size;
+   void* map = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 );
+   close( fd );
+   // la proyección sigue siendo válida después de cerrar el descriptor
+   if( map == MAP_FAILED ) return NULL;
+
+   const uint8_t* base = (const uint8_t*) map;
+
+   uint32_t flags  = get_u32( base + 12 );
+   uint64_t len    = get_u64( base + 16 );
+   uint64_t edges  = get_u64( base + 24 );
+   uint64_t keys_at    = get_u64( base + 32 );
+   uint64_t offsets_at = get_u64( base + 40 );
+   uint64_t targets_at = get_u64( base + 48 );
+   uint64_t weights_at = get_u64( base + 56 );
+
+   bool ok = memcmp( base, SNAPSHOT_MAGIC, 8 ) == 0
+      && get_u32( base + 8 ) == SNAPSHOT_VERSION
+      && len < INT32_MAX && edges <= INT32_MAX
+      && section_fits( keys_at, 4 * len, size )
+      && section_fits( offsets_at, 4 * ( len + 1 ), size )
+      && section_fits( targets_at, 4 * edges, size )
+      && ( !( flags & SNAPSHOT_FLAG_WEIGHTS ) || section_fits( weights_at, 4 * edges, size ) );
+
+   FrozenGraph* fg = ok ? (FrozenGraph*) malloc( sizeof( FrozenGraph ) ) : NULL;
+   if( !fg )
+   {
+      munmap( map, size );
+      return NULL;
+   }
+
+   fg->len = (int) len;
+   fg->edges = (int) edges;
+   fg->type = ( flags & SNAPSHOT_FLAG_DIRECTED ) ? eGraphType_DIRECTED : eGraphType_UNDIRECTED;
+
+   fg->keys    = (Item*) ( base + keys_at );
+   fg->offsets = (int*) ( base + offsets_at );
+   fg->targets = (int*) ( base + targets_at );
+   fg->weights = ( flags & SNAPSHOT_FLAG_WEIGHTS ) ? (float*) ( base + weights_at ) : NULL;
+
+   fg->map = map;
+   fg->map_len = size;
+
+   if( fg->offsets[ 0 ] != 0 || fg->offsets[ len ] != (int) edges )
+   {
+      FrozenGraph_Delete( &fg );
+   }
+
+   return fg;
+}
+
+/**
+ * @brief Revisa que los desplazamientos y los índices de las aristas sean consistentes. O(V + E).
+ *
+ * @return true si el grafo congelado es válido; false en caso contrario.
+ */
+bool FrozenGraph_Validate( const FrozenGraph* fg )
+{
+   if( fg->offsets[ 0 ] != 0 || fg->offsets[ fg->len ] != fg->edges ) return false;
+
+   for( int i = 0; i < fg->len; ++i )
+   {
+      if( fg->offsets[ i ] > fg->offsets[ i + 1 ] ) return false;
+   }
+
+   for( int e = 0; e < fg->edges; ++e )
+   {
+      if( fg->targets[ e ] < 0 || fg->targets[ e ] >= fg->len ) return false;
+   }
+
+   return true;
+}
+
+
+//----------------------------------------------------------------------
+//                          dfs_traverse()
+//----------------------------------------------------------------------
+
+// Búsqueda en profundidad iterativa a partir de |start| sobre el estado de |ctx|. Los vértices
+// que no son WHITE se consideran ya visitados. Agrega a ctx->output los vértices en el orden en
+// que terminan. No modifica al grafo. Devuelve false si se agotó la memoria para la pila (el
+// recorrido queda a medias).
+static bool dfs_run( const Graph* g, int start, TraversalContext* ctx )
+{
+   STATS_PHASE_BEGIN( t );
+
+   VertexState* st = &ctx->state;
+   int top = 0;
+
+   STATS_ADD( vertices_visited, 1 );
+   STATS_ADD( edges_scanned, neighbors_len( &g->vertices[ start ] ) );
+   // cada vértice descubierto revisa toda su lista de vecinos
+
+   state_touch( st, start );
+   st->discovery_time[ start ] = ++ctx->time;
+   st->color[ start ] = GRAY;
+   bool ok = ctx_push( ctx, &top, start, neighbors_begin( &g->vertices[ start ] ) );
+
+   while( ok && top > 0 )
+   {
+      DfsFrame* frame = &ctx->stack[ top - 1 ];
+      const Vertex* u = &g->vertices[ frame->vertex ];
+
+      // avanzamos hasta el siguiente vecino que no se haya visitado
+      int w = -1;
+      while( !neighbors_end( u, frame->pos ) )
+      {
+         int candidate = neighbors_get( frame->pos ).index;
+         frame->pos = neighbors_next( frame->pos );
+
+         if( state_color( st, candidate ) == WHITE )
+         {
+            w = candidate;
+            break;
+         }
+      }
+
+      if( w != -1 )
+      {
+         TRACE_D( "Visiting vertex: (p:%d)->%d\n", u->data, g->vertices[ w ].data );
+
+         STATS_ADD( vertices_visited, 1 );
+         STATS_ADD( edges_scanned, neighbors_len( &g->vertices[ w ] ) );
+
+         state_touch( st, w );
+         st->predecessor[ w ] = frame->vertex;
+         st->discovery_time[ w ] = ++ctx->time;
+         st->color[ w ] = GRAY;
+         ok = ctx_push( ctx, &top, w, neighbors_begin( &g->vertices[ w ] ) );
+         // |frame| ya no es válido: la pila pudo haberse movido
+      }
+      else
+      {
+         if( Vertex_HasNeighbors( u ) )
+         {
+            TRACE_D( "Returning to: %d\n", u->data );
+         }
+         else
+         {
+            TRACE_D( "Vertex %d doesn't have any neighbors\n", u->data );
+         }
+
+         st->color[ frame->vertex ] = BLACK;
+         st->finish_time[ frame->vertex ] = ++ctx->time;
+         ctx->output[ ctx->output_len++ ] = frame->vertex;
+
+         --top;
+      }
+   }
+
+   STATS_PHASE_END( eStatsPhase_DFS, t );
+
+   return ok;
+}
+
+/**
+ * @brief Búsqueda en profundidad a partir de |v|, sobre el contexto propio del grafo.
+ *
+ * Es iterativa: en lugar de una llamada recursiva por arista del árbol usa una pila de marcos
+ * en el heap, así que la profundidad del recorrido sólo está limitada por la memoria. Produce los
+ * mismos tiempos, predecesores y orden posterior que la versión recursiva.
+ *
+ * @param g       El grafo.
+ * @param v       El vértice de inicio.
+ * @param pTiempo El reloj del recorrido.
+ * @param listado Recibe los datos de los vértices en el orden en que terminaron; si se agota la
+ * memoria para la pila, sólo los que alcanzaron a terminar.
+ */
+void dfs_topol_traverse( Graph* g, Vertex* v, int* pTiempo, Queue* listado)
+{
+   TraversalContext* ctx = &g->ctx;
+
+   ctx->time = *pTiempo;
+   ctx->output_len = 0;
+
+   dfs_run( g, v->index, ctx );
+
+   for( int i = 0; i < ctx->output_len; ++i )
+   {
+      Queue_Enqueue( listado, g->vertices[ ctx->output[ i ] ].data );
+   }
+
+   *pTiempo = ctx->time;
+}
+
+/**
+ * @brief Búsqueda en profundidad a partir del vértice |start|.
+ *
+ * @param g     El grafo. No se modifica.
+ * @param start Índice del vértice de inicio.
+ * @param ctx   Recibe colores, predecesores (índices), tiempos y, en su salida, el orden posterior
+ * de los vértices alcanzados.
+ *
+ * @return El número de vértices alcanzados, o -1 si se agotó la memoria.
+ */
+int Graph_Dfs( const Graph* g, int start, TraversalContext* ctx )
+{
+   assert( 0 <= start && start < g->len );
+
+   if( !ctx_reserve( ctx, g->len ) ) return -1;
+   ctx_reset( ctx );
+
+   if( !dfs_run( g, start, ctx ) ) return -1;
+
+   return ctx->output_len;
+}
+
+/**
+ * @brief Búsqueda en amplitud a partir del vértice |start|.
+ *
+ * @param g     El grafo. No se modifica.
+ * @param start Índice del vértice de inicio.
+ * @param ctx   Recibe colores, predecesores (índices), distancias (número de aristas desde
+ * |start|; -1 para los vértices no alcanzados) y, en su salida, el orden de descubrimiento.
+ *
+ * @return El número de vértices alcanzados, o -1 si se agotó la memoria.
+ */
+int Graph_Bfs( const Graph* g, int start, TraversalContext* ctx )
+{
+   assert( 0 <= start && start < g->len );
+
+   if( !ctx_reserve( ctx, g->len ) ) return -1;
+   ctx_reset( ctx );
+
+   STATS_PHASE_BEGIN( t );
+
+   VertexState* st = &ctx->state;
+
+   // la salida hace las veces de cola: cada vértice entra una sola vez
+   int front = 0;
+   state_touch( st, start );
+   st->color[ start ] = GRAY;
+   st->distance[ start ] = 0;
+   ctx->output[ ctx->output_len++ ] = start;
+
+   while( front < ctx->output_len )
+   {
+      int v = ctx->output[ front++ ];
+
+      STATS_ADD( vertices_visited, 1 );
+      STATS_ADD( edges_scanned, neighbors_len( &g->vertices[ v ] ) );
+
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &g->vertices[ v ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         int w = NeighborIter_Get( &it ).index;
+
+         if( state_color( st, w ) == WHITE )
+         {
+            state_touch( st, w );
+            st->color[ w ] = GRAY;
+            st->distance[ w ] = st->distance[ v ] + 1;
+            st->predecessor[ w ] = v;
+            ctx->output[ ctx->output_len++ ] = w;
+         }
+      }
+      st->color[ v ] = BLACK;
+
+      STATS_MAX( queue_high_water, ctx->output_len - front );
+      // los vértices en [ front, output_len ) forman la cola
+   }
+
+   STATS_PHASE_END( eStatsPhase_BFS, t );
+
+   return ctx->output_len;
+}
+
+// Graph_BfsDirectionOptimizing() pasa a bottom-up cuando las aristas que salen de la frontera son
+// más que 1 / BFS_ALPHA de las que salen de los vértices no visitados, y regresa a top-down cuando
+// la frontera tiene menos de 1 / BFS_BETA de los vértices (los valores de Beamer et al.)
+#define BFS_ALPHA 14
+#define BFS_BETA  24
+
+/**
+ * @brief Recorrido en amplitud que alterna entre dos maneras de expandir cada nivel.
+ *
+ * Top-down: cada vértice de la frontera revisa a sus vecinos de salida, como en Graph_Bfs().
+ * Bottom-up: cada vértice no visitado revisa a sus vecinos de entrada y se detiene en el primero
+ * que esté en la frontera (guardada como mapa de bits). Cuando la frontera abarca buena parte de
+ * las aristas, como en los niveles intermedios de un grafo de diámetro pequeño, bottom-up revisa
+ * muchas menos aristas.
+ *
+ * Bottom-up necesita los vecinos de entrada (ver Graph_SetReverse()); si no se mantienen, o si no
+ * hay memoria para el mapa de bits, todos los niveles se expanden top-down.
+ *
+ * Llena el contexto igual que Graph_Bfs(): las distancias y los vértices alcanzados son los mismos,
+ * pero dentro de cada nivel los vértices descubiertos bottom-up aparecen en la salida en orden de
+ * índice, y su predecesor puede ser cualquier vértice del nivel anterior.
+ *
+ * @note Sólo conviene en grafos de diámetro pequeño con vértices de grado alto (tipo R-MAT o muy
+ * densos). En grafos de grado bajo, la contabilidad de aristas de cada nivel y los niveles
+ * bottom-up que no alcanzan a pagarse la hacen de 2 a 3 veces más lenta que Graph_Bfs(): con 20000
+ * vértices, 0.38 contra 0.20 ms en una cadena y
+ * 5.0 contra 1.7 ms en un DAG aleatorio, contra 1.7 y 4.1 ms a su favor en R-MAT (ver bench.c).
+ * Tampoco incluye el costo de Graph_SetReverse().
+ *
+ * @param g     El grafo. No se modifica.
+ * @param start Índice del vértice de inicio.
+ * @param ctx   El contexto donde se guarda el resultado.
+ *
+ * @return El número de vértices alcanzados, o -1 si se agotó la memoria.
+ */
+int Graph_BfsDirectionOptimizing( const Graph* g, int start, TraversalContext* ctx )
+{
+   assert( 0 <= start && start < g->len );
+
+   if( !ctx_reserve( ctx, g->len ) ) return -1;
+   ctx_reset( ctx );
+
+   STATS_PHASE_BEGIN( t );
+
+   VertexState* st = &ctx->state;
+   int len = g->len;
+
+   bool can_bottom_up = Graph_HasReverse( g );
+   uint64_t* frontier = NULL;
+   // se pide hasta que se necesita
+   size_t words = ( (size_t) len + 63 ) / 64;
+
+   int64_t edges_unexplored = 0;
+   // aristas que salen de los vértices no visitados
+   if( can_bottom_up )
+   {
+      for( int v = 0; v < len; ++v ) edges_unexplored += g->vertices[ v ].out_degree;
+   }
+
+   state_touch( st, start );
+   st->color[ start ] = GRAY;
+   st->distance[ start ] = 0;
+   ctx->output[ ctx->output_len++ ] = start;
+
+   int64_t edges_frontier = g->vertices[ start ].out_degree;
+   edges_unexplored -= edges_frontier;
+
+   bool bottom_up = false;
+
+   // la salida hace las veces de cola: los vértices del nivel actual están en [ begin, end )
+   int begin = 0;
+   while( begin < ctx->output_len )
+   {
+      int end = ctx->output_len;
+
+      if( can_bottom_up )
+      {
+         if( !bottom_up ) bottom_up = edges_frontier > edges_unexplored / BFS_ALPHA;
+         else bottom_up = end - begin >= len / BFS_BETA;
+      }
+
+      if( bottom_up && !frontier )
+      {
+         frontier = (uint64_t*) malloc( words * sizeof( uint64_t ) );
+         if( !frontier ) can_bottom_up = bottom_up = false;
+      }
+
+      TRACE_I( "BfsDirectionOptimizing(): level with %d vertices, %s\n", end - begin, bottom_up ? "bottom-up" : "top-down" );
+
+      edges_frontier = 0;
+
+      if( bottom_up )
+      {
+         memset( frontier, 0, words * sizeof( uint64_t ) );
+         for( int i = begin; i < end; ++i )
+         {
+            int v = ctx->output[ i ];
+            frontier[ v / 64 ] |= (uint64_t) 1 << ( v % 64 );
+         }
+
+         for( int w = 0; w < len; ++w )
+         {
+            if( state_color( st, w ) != WHITE ) continue;
+
+            NeighborIter it;
+            for( NeighborIter_StartIn( &it, g, w ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+            {
+               int v = NeighborIter_Get( &it ).index;
+               STATS_ADD( edges_scanned, 1 );
+
+               if( frontier[ v / 64 ] & ( (uint64_t) 1 << ( v % 64 ) ) )
+               {
+                  state_touch( st, w );
+                  st->color[ w ] = GRAY;
+                  st->distance[ w ] = st->distance[ v ] + 1;
+                  st->predecessor[ w ] = v;
+                  ctx->output[ ctx->output_len++ ] = w;
+
+                  edges_frontier += g->vertices[ w ].out_degree;
+                  break;
+               }
+            }
+         }
+      }
+      else
+      {
+         for( int i = begin; i < end; ++i )
+         {
+            int v = ctx->output[ i ];
+
+            STATS_ADD( edges_scanned, neighbors_len( &g->vertices[ v ] ) );
+
+            NeighborIter it;
+            for( NeighborIter_Start( &it, &g->vertices[ v ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+            {
+               int w = NeighborIter_Get( &it ).index;
+
+               if( state_color( st, w ) == WHITE )
+               {
+                  state_touch( st, w );
+                  st->color[ w ] = GRAY;
+                  st->distance[ w ] = st->distance[ v ] + 1;
+                  st->predecessor[ w ] = v;
+                  ctx->output[ ctx->output_len++ ] = w;
+
+                  edges_frontier += g->vertices[ w ].out_degree;
+               }
+            }
+         }
+      }
+
+      for( int i = begin; i < end; ++i ) st->color[ ctx->output[ i ] ] = BLACK;
+
+      STATS_ADD( vertices_visited, end - begin );
+      STATS_MAX( queue_high_water, ctx->output_len - end );
+
+      edges_unexplored -= edges_frontier;
+      begin = end;
+   }
+
+   free( frontier );
+
+   STATS_PHASE_END( eStatsPhase_BFS, t );
+
+   return ctx->output_len;
+}
+
+/**
+ * @brief Reconstruye el camino del árbol del último recorrido desde la raíz hasta |target|.
+ *
+ * Sigue a los predecesores (que son índices), así que cuesta O(L), donde L es la longitud del
+ * camino.
+ *
+ * @param ctx    El contexto de un recorrido (Graph_Dfs(), Graph_Bfs(), Graph_BfsDirectionOptimizing()).
+ * @param target Índice del vértice de llegada.
+ * @param out    Recibe los índices de los vértices del camino, empezando por la raíz y terminando
+ * en |target|. Debe tener lugar para el número de vértices del grafo. Puede ser NULL.
+ *
+ * @return El número de vértices del camino, o 0 si el recorrido no alcanzó a |target|.
+ */
+int Graph_ExtractPath( const TraversalContext* ctx, int target, int* out )
+{
+   assert( 0 <= target && target < ctx->state.capacity );
+
+   if( state_color( &ctx->state, target ) == WHITE ) return 0;
+
+   int len = 0;
+   for( int v = target; v != -1; v = TraversalContext_GetPredecessor( ctx, v ) ) ++len;
+
+   if( out )
+   {
+      int i = len;
+      for( int v = target; v != -1; v = TraversalContext_GetPredecessor( ctx, v ) ) out[ --i ] = v;
+   }
+
+   return len;
+}
+
+void dfs_topol( Graph* g, int start ){
+   ctx_reset( &g->ctx );
+   // todos los vértices quedan WHITE, sin predecesor y con tiempos en 0
+
+   Queue* lista = Queue_New( Graph_GetLen( g ) );
+
+   Vertex_SetColor( Graph_GetVertexByKey( g, start ), GRAY );
+   TRACE_I( "Visiting start node: %d\n", start );
+   
+   int time_ = 0;
+   dfs_topol_traverse( g, Graph_GetVertexByKey( g, start), &time_ , lista);
+   
+   for( int i = 0; !Queue_IsEmpty(lista); ++i )
+   {
+      int guardado = Queue_Dequeue(lista);
+      Vertex* v = Graph_GetVertexByKey( g, guardado );
+
+      int pred = Vertex_GetPredecessor( v );
+      // el predecesor es un índice; lo imprimimos como dato
+
+      printf( "[%d] (%d) -- Pred: %d\n",
+            i,
+            Vertex_GetData( v ),
+            pred != -1 ? Graph_GetDataByIndex( g, pred ) : -1 );
+   }
+
+   Queue_Delete( &lista );
+}
+
+//----------------------------------------------------------------------
+//                       Topological sort
+//----------------------------------------------------------------------
+
+// Búsqueda en profundidad iterativa sobre todos los vértices que no estén marcados en |skip|.
+// order: si no es NULL, recibe el orden topológico (se llena de atrás hacia adelante empezando
+//        en order[ n - 1 ], donde n es el número de vértices no marcados)
+// cycle, cycle_len: reciben el primer ciclo que se encuentre
+// ret: eTopoSort_OK, eTopoSort_CYCLE o eTopoSort_NOMEM
+static eTopoSortResult topo_dfs( const Graph* g, const uint8_t* skip, int* order, int* cycle, int* cycle_len )
+{
+   int len = g->len;
+
+   uint8_t* color = (uint8_t*) calloc( len > 0 ? len : 1, sizeof( uint8_t ) );
+   DfsFrame* stack = (DfsFrame*) malloc( ( len > 0 ? len : 1 ) * sizeof( DfsFrame ) );
+   // cada vértice está a lo más una vez en la pila
+   if( !color || !stack )
+   {
+      free( color );
+      free( stack );
+      return eTopoSort_NOMEM;
+   }
+
+   int remaining = 0;
+   for( int i = 0; i < len; ++i )
+   {
+      if( skip && skip[ i ] ) color[ i ] = BLACK;
+      else ++remaining;
+   }
+
+   eTopoSortResult result = eTopoSort_OK;
+
+   for( int root = 0; root < len && result == eTopoSort_OK; ++root )
+   {
+      if( color[ root ] != WHITE ) continue;
+
+      int top = 0;
+      color[ root ] = GRAY;
+      stack[ top ].vertex = root;
+      stack[ top ].pos = neighbors_begin( &g->vertices[ root ] );
+      ++top;
+
+      while( top > 0 )
+      {
+         DfsFrame* frame = &stack[ top - 1 ];
+         const Vertex* u = &g->vertices[ frame->vertex ];
+
+         if( !neighbors_end( u, frame->pos ) )
+         {
+            int w = neighbors_get( frame->pos ).index;
+            frame->pos = neighbors_next( frame->pos );
+
+            if( color[ w ] == WHITE )
+            {
+               color[ w ] = GRAY;
+               stack[ top ].vertex = w;
+               stack[ top ].pos = neighbors_begin( &g->vertices[ w ] );
+               ++top;
+            }
+            else if( color[ w ] == GRAY )
+            {
+               // arista de retroceso: el ciclo es el tramo de la pila desde |w| hasta |u|
+               int from = top - 1;
+               while( stack[ from ].vertex != w ) --from;
+
+               if( cycle )
+               {
+                  for( int i = from; i < top; ++i ) cycle[ i - from ] = stack[ i ].vertex;
+               }
+               if( cycle_len ) *cycle_len = top - from;
+
+               result = eTopoSort_CYCLE;
+               break;
+            }
+         }
+         else
+         {
+            color[ frame->vertex ] = BLACK;
+            if( order ) order[ --remaining ] = frame->vertex;
+            --top;
+         }
+      }
+   }
+
+   free( stack );
+   free( color );
+   return result;
+}
+
+// Se llama cuando el algoritmo de Kahn sólo pudo sacar a |done_len| vértices (los que están en
+// order[ 0 ] ... order[ done_len - 1 ]). Los que no salieron tienen un predecesor que tampoco
+// salió, así que entre ellos hay un ciclo; lo buscamos con la búsqueda en profundidad ignorando a
+// los que sí salieron.
+static eTopoSortResult kahn_find_cycle( const Graph* g, const int* order, int done_len, int* cycle, int* cycle_len )
+{
+   uint8_t* done = (uint8_t*) calloc( g->len, sizeof( uint8_t ) );
+   if( !done ) return eTopoSort_NOMEM;
+
+   for( int i = 0; i < done_len; ++i ) done[ order[ i ] ] = 1;
+
+   eTopoSortResult result = topo_dfs( g, done, NULL, cycle, cycle_len );
+   assert( result != eTopoSort_OK );
+
+   free( done );
+   return result;
+}
+
+// implementa Graph_TopologicalSort(); la función pública sólo agrega la medición del tiempo
+static eTopoSortResult topological_sort( const Graph* g, eTopoSortMethod method, int* order, int* cycle, int* cycle_len )
+{
+   if( cycle_len ) *cycle_len = 0;
+
+   if( method == eTopoSort_DFS ) return topo_dfs( g, NULL, order, cycle, cycle_len );
+
+   int len = g->len;
+
+   int* in_degree = (int*) malloc( ( len > 0 ? len : 1 ) * sizeof( int ) );
+   if( !in_degree ) return eTopoSort_NOMEM;
+
+   for( int i = 0; i < len; ++i ) in_degree[ i ] = g->vertices[ i ].in_degree;
+
+   // |order| hace las veces de cola: cada vértice entra una sola vez
+   int front = 0;
+   int back = 0;
+   for( int i = 0; i < len; ++i )
+   {
+      if( in_degree[ i ] == 0 ) order[ back++ ] = i;
+   }
+
+   while( front < back )
+   {
+      const Vertex* v = &g->vertices[ order[ front++ ] ];
+
+      NeighborIter it;
+      for( NeighborIter_Start( &it, v ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         int w = NeighborIter_Get( &it ).index;
+
+         if( --in_degree[ w ] == 0 ) order[ back++ ] = w;
+      }
+   }
+
+   free( in_degree );
+
+   if( back == len ) return eTopoSort_OK;
+
+   return kahn_find_cycle( g, order, back, cycle, cycle_len );
+}
+
+/**
+ * @brief Ordena topológicamente a todos los vértices del grafo en tiempo O(V + E).
+ *
+ * @param g         El grafo. No se modifica.
+ * @param method    eTopoSort_DFS o eTopoSort_KAHN. Ambos producen un orden válido, aunque no
+ * necesariamente el mismo.
+ * @param order     Recibe los índices de los vértices en orden topológico.
+ * @param cycle     Si el grafo tiene un ciclo recibe los índices de uno de ellos: cycle[ 0 ] ->
+ * cycle[ 1 ] -> ... -> cycle[ *cycle_len - 1 ] -> cycle[ 0 ]. Puede ser NULL.
+ * @param cycle_len Recibe el número de vértices del ciclo. Puede ser NULL.
+ *
+ * @return eTopoSort_OK si el grafo es acíclico; eTopoSort_CYCLE si tiene un ciclo (el contenido
+ * de |order| queda indefinido); eTopoSort_NOMEM si se agotó la memoria.
+ *
+ * @pre |order| y |cycle| (si no es NULL) tienen al menos Graph_GetLen() elementos.
+ * @note En un grafo no dirigido cada arista forma un ciclo de longitud 2.
+ */
+eTopoSortResult Graph_TopologicalSort( const Graph* g, eTopoSortMethod method, int* order, int* cycle, int* cycle_len )
+{
+   STATS_PHASE_BEGIN( t );
+   eTopoSortResult ret = topological_sort( g, method, order, cycle, cycle_len );
+   STATS_PHASE_END( eStatsPhase_TOPOSORT, t );
+
+   return ret;
+}
+
+//----------------------------------------------------------------------
+//                  Parallel topological sort
+//----------------------------------------------------------------------
+
+/**
+ * @brief Arreglo dinámico de enteros; cada hilo tiene los suyos.
+ */
+typedef struct
+{
+   int* items;
+   int len;
+   int capacity;
+} IntBuffer;
+
+static bool IntBuffer_Push( IntBuffer* buf, int value )
+{
+   if( buf->len == buf->capacity )
+   {
+      int capacity = buf->capacity ? 2 * buf->capacity : 64;
+      int* items = (int*) realloc( buf->items, capacity * sizeof( int ) );
+      if( !items ) return false;
+
+      buf->items = items;
+      buf->capacity = capacity;
+   }
+
+   buf->items[ buf->len++ ] = value;
+   return true;
+}
+
+static int cmp_int( const void* a, const void* b )
+{
+   int x = *(const int*) a;
+   int y = *(const int*) b;
+   return ( x > y ) - ( x < y );
+}
+
+/**
+ * @brief Estado compartido por los hilos del ordenamiento topológico paralelo.
+ *
+ * Los índices de los vértices se reparten en |num_threads| bloques contiguos de |block| vértices;
+ * el hilo j es el dueño del bloque j. Cuando un hilo deja a un vértice con grado de entrada 0 lo
+ * guarda en buffers[ hilo * num_threads + dueño ]; después cada dueño junta y ordena a los suyos.
+ * Como los bloques están ordenados, cada nivel queda ordenado por índice sin importar cuántos
+ * hilos se usen.
+ */
+typedef struct
+{
+   const Graph* g;
+   int num_threads;
+   int block;
+
+   int* in_degree;      ///< se modifica con operaciones atómicas
+   int* order;
+   int* level;          ///< puede ser NULL
+
+   IntBuffer* buffers;  ///< num_threads * num_threads
+   int* counts;         ///< vértices del siguiente nivel que le tocan a cada dueño
+
+   pthread_mutex_t gate_mutex;  ///< los hilos esperan aquí a que se sepa cuántos arrancaron
+   pthread_cond_t gate_cond;
+   bool gate_open;
+
+   pthread_barrier_t barrier;
+   int failed;          ///< distinto de 0 si algún hilo se quedó sin memoria
+   int produced;        ///< vértices en |order| al terminar
+} ParTopo;
+
+typedef struct
+{
+   ParTopo* shared;
+   int id;
+} ParTopoWorker;
+
+static void par_topo_push( ParTopo* s, int id, int w )
+{
+   int owner = w / s->block;
+
+   if( !IntBuffer_Push( &s->buffers[ id * s->num_threads + owner ], w ) )
+   {
+      __atomic_store_n( &s->failed, 1, __ATOMIC_RELAXED );
+   }
+}
+
+static void* par_topo_worker( void* arg )
+{
+   ParTopoWorker* worker = (ParTopoWorker*) arg;
+   ParTopo* s = worker->shared;
+   int id = worker->id;
+
+   pthread_mutex_lock( &s->gate_mutex );
+   while( !s->gate_open ) pthread_cond_wait( &s->gate_cond, &s->gate_mutex );
+   pthread_mutex_unlock( &s->gate_mutex );
+
+   if( id >= s->num_threads ) return NULL;
+
+   int num_threads = s->num_threads;
+   const Graph* g = s->g;
+
+   int lo = id * s->block;
+   int hi = lo + s->block < g->len ? lo + s->block : g->len;
+
+   // grados de entrada: cada hilo recorre las aristas que salen de su bloque
+   for( int i = lo; i < hi; ++i )
+   {
+      const Vertex* v = &g->vertices[ i ];
+
+      NeighborIter it;
+      for( NeighborIter_Start( &it, v ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         __atomic_fetch_add( &s->in_degree[ NeighborIter_Get( &it ).index ], 1, __ATOMIC_RELAXED );
+      }
+   }
+
+   pthread_barrier_wait( &s->barrier );
+
+   // las fuentes forman el nivel 0; cada hilo aporta las de su bloque
+   for( int i = lo; i < hi; ++i )
+   {
+      if( s->in_degree[ i ] == 0 ) par_topo_push( s, id, i );
+   }
+
+   int level_end = 0;
+   int current_level = 0;
+
+   while( true )
+   {
+      pthread_barrier_wait( &s->barrier );
+
+      // cada dueño cuenta cuántos vértices del siguiente nivel le tocan...
+      int count = 0;
+      for( int t = 0; t < num_threads; ++t ) count += s->buffers[ t * num_threads + id ].len;
+      s->counts[ id ] = count;
+
+      pthread_barrier_wait( &s->barrier );
+
+      // ... y los copia, ordenados, a su tramo de |order|
+      int offset = level_end;
+      int total = 0;
+      for( int j = 0; j < num_threads; ++j )
+      {
+         if( j < id ) offset += s->counts[ j ];
+         total += s->counts[ j ];
+      }
+
+      int pos = offset;
+      for( int t = 0; t < num_threads; ++t )
+      {
+         IntBuffer* buf = &s->buffers[ t * num_threads + id ];
+
+         for( int i = 0; i < buf->len; ++i )
+         {
+            int w = buf->items[ i ];
+            s->order[ pos++ ] = w;
+            if( s->level ) s->level[ w ] = current_level;
+         }
+         buf->len = 0;
+      }
+      qsort( s->order + offset, count, sizeof( int ), cmp_int );
+
+      int level_start = level_end;
+      level_end += total;
+
+      // |failed| sólo cambia durante la expansión, así que leído antes de la barrera todos los
+      // hilos ven el mismo valor y salen juntos; leído después, un hilo rápido podría cambiarlo
+      bool failed = __atomic_load_n( &s->failed, __ATOMIC_RELAXED );
+
+      pthread_barrier_wait( &s->barrier );
+
+      if( total == 0 || failed ) break;
+
+      // expansión: cada hilo toma un tramo contiguo del nivel actual
+      int chunk = ( total + num_threads - 1 ) / num_threads;
+      int from = level_start + id * chunk;
+      int to = from + chunk < level_end ? from + chunk : level_end;
+
+      for( int i = from; i < to; ++i )
+      {
+         const Vertex* v = &g->vertices[ s->order[ i ] ];
+
+         NeighborIter it;
+         for( NeighborIter_Start( &it, v ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+         {
+            int w = NeighborIter_Get( &it ).index;
+
+            if( __atomic_sub_fetch( &s->in_degree[ w ], 1, __ATOMIC_ACQ_REL ) == 0 )
+            {
+               par_topo_push( s, id, w );
+            }
+         }
+      }
+
+      ++current_level;
+   }
+
+   if( id == 0 ) s->produced = level_end;
+
+   return NULL;
+}
+
+// implementa Graph_TopologicalSortParallel(); la función pública sólo agrega la medición del tiempo
+static eTopoSortResult topological_sort_parallel( const Graph* g, int num_threads, int* order, int* level, int* cycle, int* cycle_len )
+{
+   if( cycle_len ) *cycle_len = 0;
+   if( g->len == 0 ) return eTopoSort_OK;
+
+   if( num_threads <= 0 ) num_threads = (int) sysconf( _SC_NPROCESSORS_ONLN );
+   if( num_threads <= 0 ) num_threads = 1;
+   if( num_threads > g->len ) num_threads = g->len;
+
+   ParTopo s;
+   s.g = g;
+   s.order = order;
+   s.level = level;
+   s.failed = 0;
+   s.produced = 0;
+
+   s.in_degree = (int*) calloc( g->len, sizeof( int ) );
+   s.buffers = (IntBuffer*) calloc( num_threads * num_threads, sizeof( IntBuffer ) );
+   s.counts = (int*) calloc( num_threads, sizeof( int ) );
+   ParTopoWorker* workers = (ParTopoWorker*) malloc( num_threads * sizeof( ParTopoWorker ) );
+   pthread_t* threads = (pthread_t*) malloc( num_threads * sizeof( pthread_t ) );
+
+   eTopoSortResult result = eTopoSort_NOMEM;
+
+   if( s.in_degree && s.buffers && s.counts && workers && threads )
+   {
+      s.gate_open = false;
+      pthread_mutex_init( &s.gate_mutex, NULL );
+      pthread_cond_init( &s.gate_cond, NULL );
+
+      // el hilo que llama hace el trabajo del hilo 0; si no se pueden crear todos los hilos se
+      // trabaja con los que sí arrancaron
+      int started = 1;
+      for( int t = 0; t < num_threads; ++t )
+      {
+         workers[ t ].shared = &s;
+         workers[ t ].id = t;
+      }
+      for( int t = 1; t < num_threads; ++t )
+      {
+         if( pthread_create( &threads[ t ], NULL, par_topo_worker, &workers[ t ] ) != 0 ) break;
+         ++started;
+      }
+
+      s.num_threads = started;
+      s.block = ( g->len + started - 1 ) / started;
+      bool barrier_ok = pthread_barrier_init( &s.barrier, NULL, started ) == 0;
+      if( !barrier_ok )
+      {
+         // sin barrera sólo puede trabajar el hilo 0; los demás terminan en cuanto se abra la puerta
+         s.num_threads = 1;
+         s.block = g->len;
+         barrier_ok = pthread_barrier_init( &s.barrier, NULL, 1 ) == 0;
+      }
+
+      pthread_mutex_lock( &s.gate_mutex );
+      s.gate_open = true;
+      pthread_cond_broadcast( &s.gate_cond );
+      pthread_mutex_unlock( &s.gate_mutex );
+
+      if( barrier_ok ) par_topo_worker( &workers[ 0 ] );
+
+      for( int t = 1; t < started; ++t ) pthread_join( threads[ t ], NULL );
+
+      if( !barrier_ok || s.failed )   result = eTopoSort_NOMEM;
+      else if( s.produced == g->len ) result = eTopoSort_OK;
+      else result = kahn_find_cycle( g, order, s.produced, cycle, cycle_len );
+
+      if( barrier_ok ) pthread_barrier_destroy( &s.barrier );
+      pthread_cond_destroy( &s.gate_cond );
+      pthread_mutex_destroy( &s.gate_mutex );
+   }
+
+   if( s.buffers )
+   {
+      for( int i = 0; i < num_threads * num_threads; ++i ) free( s.buffers[ i ].items );
+   }
+   free( threads );
+   free( workers );
+   free( s.counts );
+   free( s.buffers );
+   free( s.in_degree );
+
+   return result;
+}
+
+/**
+ * @brief Ordenamiento topológico de Kahn por niveles, usando varios hilos.
+ *
+ * Los vértices se procesan por frentes de onda: el nivel 0 son las fuentes y el nivel k + 1 son los
+ * vértices cuyo último predecesor está en el nivel k. Cada nivel se reparte entre los hilos, y los
+ * grados de entrada se decrementan de manera atómica. Dentro de cada nivel los vértices quedan
+ * ordenados por índice, así que el resultado no depende del número de hilos.
+ *
+ * @param g           El grafo. No se modifica.
+ * @param num_threads Número de hilos; 0 o menos para usar uno por procesador.
+ * @param order       Recibe los índices de los vértices en orden topológico.
+ * @param level       Recibe el nivel (frente de onda) de cada vértice. Puede ser NULL.
+ * @param cycle       Como en Graph_TopologicalSort(). Puede ser NULL.
+ * @param cycle_len   Como en Graph_TopologicalSort(). Puede ser NULL.
+ *
+ * @return Como en Graph_TopologicalSort().
+ *
+ * @pre |order|, |level| y |cycle| (si no son NULL) tienen al menos Graph_GetLen() elementos.
+ */
+eTopoSortResult Graph_TopologicalSortParallel( const Graph* g, int num_threads, int* order, int* level, int* cycle, int* cycle_len )
+{
+   STATS_PHASE_BEGIN( t );
+   eTopoSortResult ret = topological_sort_parallel( g, num_threads, order, level, cycle, cycle_len );
+   STATS_PHASE_END( eStatsPhase_TOPOSORT, t );
+
+   return ret;
+}
+
+//----------------------------------------------------------------------
+//                         Bulk loading
+//----------------------------------------------------------------------
+
+// Ejecuta fn( args + i * arg_size ) para i = 0 ... num_threads - 1, cada una en su propio hilo
+// (la 0 en el hilo que llama), y espera a que todas terminen. Si no se puede crear algún hilo, su
+// trabajo se hace en el hilo que llama.
+static void parallel_run( int num_threads, void* (*fn)( void* ), void* args, size_t arg_size )
+{
+   pthread_t* threads = (pthread_t*) malloc( num_threads * sizeof( pthread_t ) );
+   bool* started = (bool*) calloc( num_threads, sizeof( bool ) );
+
+   for( int t = 1; t < num_threads && threads && started; ++t )
+   {
+      started[ t ] = pthread_create( &threads[ t ], NULL, fn, (char*) args + t * arg_size ) == 0;
+   }
+
+   fn( args );
+
+   for( int t = 1; t < num_threads; ++t )
+   {
+      if( started && started[ t ] ) pthread_join( threads[ t ], NULL );
+      else fn( (char*) args + t * arg_size );
+   }
+
+   free( started );
+   free( threads );
+}
+
+static int default_num_threads( int num_threads )
+{
+   if( num_threads <= 0 ) num_threads = (int) sysconf( _SC_NPROCESSORS_ONLN );
+   return num_threads > 0 ? num_threads : 1;
+}
+
+/**
+ * @brief Un lote de aristas: src[ i ] -> dst[ i ] con peso w[ i ].
+ */
+typedef struct
+{
+   int* src;
+   int* dst;
+   float* w;      ///< puede ser NULL (todos los pesos son 0)
+   size_t len;
+} EdgeBatch;
+
+// Agrega al grafo las aristas de los lotes, cuyos extremos ya son índices de vértices.
+//
+// Ordena las aristas por vértice de origen con un ordenamiento por conteo (conservando el orden
+// de llegada dentro de cada vértice) y luego llena la lista de vecinos de cada vértice de una
+// sola vez. Los duplicados se rechazan igual que en Graph_AddEdge(). En un grafo no dirigido
+// cada arista se agrega en ambos sentidos.
+//
+// ret: false si se agotó la memoria (el grafo queda sin cambios)
+static bool bulk_build( Graph* g, const EdgeBatch* batches, int num_batches )
+{
+   bool undirected = g->type == eGraphType_UNDIRECTED;
+
+   size_t total = 0;
+   for( int b = 0; b < num_batches; ++b ) total += batches[ b ].len;
+   if( undirected ) total *= 2;
+
+   size_t* start = (size_t*) calloc( g->len + 1, sizeof( size_t ) );
+   int* sorted_dst = (int*) malloc( ( total > 0 ? total : 1 ) * sizeof( int ) );
+   float* sorted_w = (float*) malloc( ( total > 0 ? total : 1 ) * sizeof( float ) );
+   if( !start || !sorted_dst || !sorted_w )
+   {
+      free( start );
+      free( sorted_dst );
+      free( sorted_w );
+      return false;
+   }
+
+   // conteo: start[ v + 1 ] = número de aristas que salen de v
+   for( int b = 0; b < num_batches; ++b )
+   {
+      for( size_t i = 0; i < batches[ b ].len; ++i )
+      {
+         ++start[ batches[ b ].src[ i ] + 1 ];
+         if( undirected ) ++start[ batches[ b ].dst[ i ] + 1 ];
+      }
+   }
+   for( int v = 0; v < g->len; ++v ) start[ v + 1 ] += start[ v ];
+
+   // reparto: al terminar, start[ v ] apunta al final del tramo de v
+   for( int b = 0; b < num_batches; ++b )
+   {
+      const EdgeBatch* batch = &batches[ b ];
+
+      for( size_t i = 0; i < batch->len; ++i )
+      {
+         float w = batch->w ? batch->w[ i ] : 0.0;
+
+         size_t pos = start[ batch->src[ i ] ]++;
+         sorted_dst[ pos ] = batch->dst[ i ];
+         sorted_w[ pos ] = w;
+
+         if( undirected )
+         {
+            pos = start[ batch->dst[ i ] ]++;
+            sorted_dst[ pos ] = batch->src[ i ];
+            sorted_w[ pos ] = w;
+         }
+      }
+   }
+
+   size_t from = 0;
+   for( int v = 0; v < g->len; ++v )
+   {
+      size_t to = start[ v ];
+      Vertex* vertex = &g->vertices[ v ];
+
+#if VERTEX_USE_SMALLVEC
+      DataVec_Reserve( &vertex->neighbors, DataVec_Len( &vertex->neighbors ) + (int) ( to - from ) );
+#endif
+
+      for( size_t i = from; i < to; ++i )
+      {
+         if( is_new_edge( g, v, sorted_dst[ i ] ) ) push_neighbor( g, vertex, sorted_dst[ i ], sorted_w[ i ] );
+      }
+
+      from = to;
+   }
+
+   free( sorted_w );
+   free( sorted_dst );
+   free( start );
+   return true;
+}
+
+/**
+ * @brief Un pedazo del archivo de aristas y lo que se obtuvo al leerlo.
+ */
+typedef struct
+{
+   const char* begin;
+   const char* end;
+
+   int* src;        ///< llaves de los vértices de origen (después, sus índices)
+   int* dst;        ///< llaves de los vértices de destino (después, sus índices)
+   float* w;
+   size_t len;
+   size_t capacity;
+
+   bool error;      ///< línea mal formada o falta de memoria
+} EdgeChunk;
+
+static bool EdgeChunk_Push( EdgeChunk* chunk, int src, int dst, float w )
+{
+   if( chunk->len == chunk->capacity )
+   {
+      size_t capacity = chunk->capacity ? 2 * chunk->capacity : 1024;
+
+      int* s = (int*) realloc( chunk->src, capacity * sizeof( int ) );
+      if( s ) chunk->src = s;
+      int* d = (int*) realloc( chunk->dst, capacity * sizeof( int ) );
+      if( d ) chunk->dst = d;
+      float* f = (float*) realloc( chunk->w, capacity * sizeof( float ) );
+      if( f ) chunk->w = f;
+
+      if( !s || !d || !f ) return false;
+      chunk->capacity = capacity;
+   }
+
+   chunk->src[ chunk->len ] = src;
+   chunk->dst[ chunk->len ] = dst;
+   chunk->w[ chunk->len ] = w;
+   ++chunk->len;
+   return true;
+}
+
+static bool is_blank( char c )
+{
+   return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static const char* skip_blanks( const char* p, const char* end )
+{
+   while( p < end && is_blank( *p ) ) ++p;
+   return p;
+}
+
+// lee un entero en [ p, end ); devuelve la posición siguiente, o NULL si no hay un entero válido
+static const char* parse_int( const char* p, const char* end, int* value )
+{
+   bool negative = false;
+   if( p < end && ( *p == '-' || *p == '+' ) )
+   {
+      negative = *p == '-';
+      ++p;
+   }
+
+   const char* digits = p;
+   int64_t x = 0;
+   while( p < end && (unsigned) ( *p - '0' ) < 10 )
+   {
+      x = x * 10 + ( *p - '0' );
+      if( x > (int64_t) INT32_MAX + 1 ) return NULL;
+      ++p;
+   }
+
+   if( p == digits ) return NULL;
+
+   x = negative ? -x : x;
+   if( x > INT32_MAX ) return NULL;
+
+   *value = (int) x;
+   return p;
+}
+
+// lee un número real ([signo]dígitos[.dígitos][e[signo]dígitos]); devuelve la posición siguiente,
+// o NULL si no hay un número válido
+static const char* parse_float( const char* p, const char* end, float* value )
+{
+   bool negative = false;
+   if( p < end && ( *p == '-' || *p == '+' ) )
+   {
+      negative = *p == '-';
+      ++p;
+   }
+
+   double x = 0.0;
+   int digits = 0;
+   while( p < end && (unsigned) ( *p - '0' ) < 10 )
+   {
+      x = x * 10.0 + ( *p - '0' );
+      ++p;
+      ++digits;
+   }
+
+   if( p < end && *p == '.' )
+   {
+      ++p;
+      double scale = 0.1;
+      while( p < end && (unsigned) ( *p - '0' ) < 10 )
+      {
+         x += ( *p - '0' ) * scale;
+         scale *= 0.1;
+         ++p;
+         ++digits;
+      }
+   }
+
+   if( digits == 0 ) return NULL;
+
+   if( p < end && ( *p == 'e' || *p == 'E' ) )
+   {
+      int exponent;
+      p = parse_int( p + 1, end, &exponent );
+      if( !p ) return NULL;
+
+      // la mantisa está entre 1e-324 y 1e308, así que más allá de +-800 el resultado ya es inf o 0;
+      // sin el límite, "1e2000000000" tardaría segundos en este ciclo
+      if( exponent > 800 ) exponent = 800;
+      if( exponent < -800 ) exponent = -800;
+
+      for( ; exponent > 0; --exponent ) x *= 10.0;
+      for( ; exponent < 0; ++exponent ) x /= 10.0;
+   }
+
+   *value = (float) ( negative ? -x : x );
+   return p;
+}
+
+// lee las líneas "src dst [peso]" del pedazo; las líneas vacías y las que empiezan con '#' o '%'
+// se ignoran
+static void* parse_chunk( void* arg )
+{
+   EdgeChunk* chunk = (EdgeChunk*) arg;
+   const char* p = chunk->begin;
+   const char* end = chunk->end;
+
+   while( p < end && !chunk->error )
+   {
+      p = skip_blanks( p, end );
+
+      if( p == end ) break;
+
+      if( *p == '\n' )
+      {
+         ++p;
+         continue;
+      }
+
+      if( *p == '#' || *p == '%' )
+      {
+         while( p < end && *p != '\n' ) ++p;
+         continue;
+      }
+
+      int src, dst;
+      float w = 0.0;
+
+      p = parse_int( p, end, &src );
+      if( p ) p = skip_blanks( p, end );
+      if( p ) p = parse_int( p, end, &dst );
+      if( p ) p = skip_blanks( p, end );
+      if( p && p < end && *p != '\n' )
+      {
+         p = parse_float( p, end, &w );
+         if( p ) p = skip_blanks( p, end );
+      }
+
+      if( !p || ( p < end && *p != '\n' ) || !EdgeChunk_Push( chunk, src, dst, w ) )
+      {
+         chunk->error = true;
+      }
+   }
+
+   return NULL;
+}
+
+// implementa Graph_LoadEdgeList(); la función pública sólo agrega la medición del tiempo
+static Graph* load_edge_list( const char* path, eGraphType type, int num_threads )
+{
+   num_threads = default_num_threads( num_threads );
+
+   int fd = open( path, O_RDONLY );
+   if( fd < 0 ) return NULL;
+
+   struct stat st;
+   if( fstat( fd, &st ) != 0 )
+   {
+      close( fd );
+      return NULL;
+   }
+
+   size_t size = (size_t) st.st_size;
+   void* map = size > 0 ? mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 ) : NULL;
+   close( fd );
+   if( map == MAP_FAILED ) return NULL;
+
+   const char* text = (const char*) map;
+
+   // no vale la pena un hilo para menos de una página
+   if( (size_t) num_threads > size / 4096 + 1 ) num_threads = (int) ( size / 4096 + 1 );
+
+   EdgeChunk* chunks = (EdgeChunk*) calloc( num_threads, sizeof( EdgeChunk ) );
+   if( !chunks )
+   {
+      if( map ) munmap( map, size );
+      return NULL;
+   }
+
+   // cada pedazo empieza justo después de un salto de línea
+   const char* cut = text;
+   for( int t = 0; t < num_threads; ++t )
+   {
+      const char* end = text + size * ( t + 1 ) / num_threads;
+      if( end < cut ) end = cut;
+      while( end < text + size && end > text && end[ -1 ] != '\n' ) ++end;
+
+      chunks[ t ].begin = cut;
+      chunks[ t ].end = end;
+      cut = end;
+   }
+
+   parallel_run( num_threads, parse_chunk, chunks, sizeof( EdgeChunk ) );
+
+   bool ok = true;
+   for( int t = 0; t < num_threads; ++t ) ok = ok && !chunks[ t ].error;
+
+   // las llaves se numeran en el orden en que aparecen en el archivo, así que esta pasada es
+   // secuencial; se hace una sola búsqueda por extremo, directamente en el índice del grafo, y de
+   // paso las llaves de los pedazos se cambian por los índices
+   size_t edges = 0;
+   for( int t = 0; t < num_threads; ++t ) edges += chunks[ t ].len;
+
+   size_t guess = edges / 4 + 1;
+   // no se sabe cuántos vértices hay; la capacidad crece sola y al final se ajusta
+   Graph* g = ok ? Graph_New( guess < INT_MAX ? (int) guess : INT_MAX, type ) : NULL;
+
+   for( int t = 0; t < num_threads && g; ++t )
+   {
+      for( size_t i = 0; i < chunks[ t ].len && g; ++i )
+      {
+         int* pair[ 2 ] = { &chunks[ t ].src[ i ], &chunks[ t ].dst[ i ] };
+
+         for( int k = 0; k < 2 && g; ++k )
+         {
+            int index = find( g, *pair[ k ] );
+            if( index == -1 )
+            {
+               index = g->len;
+               if( !Graph_AddVertex( g, *pair[ k ] ) ) Graph_Delete( &g );
+            }
+
+            *pair[ k ] = index;
+         }
+      }
+   }
+
+   if( g )
+   {
+      Graph_ShrinkToFit( g );
+
+      EdgeBatch* batches = (EdgeBatch*) malloc( num_threads * sizeof( EdgeBatch ) );
+      if( batches )
+      {
+         for( int t = 0; t < num_threads; ++t )
+         {
+            batches[ t ].src = chunks[ t ].src;
+            batches[ t ].dst = chunks[ t ].dst;
+            batches[ t ].w = chunks[ t ].w;
+            batches[ t ].len = chunks[ t ].len;
+         }
+      }
+
+      if( !batches || !bulk_build( g, batches, num_threads ) ) Graph_Delete( &g );
+
+      free( batches );
+   }
+
+   for( int t = 0; t < num_threads; ++t )
+   {
+      free( chunks[ t ].src );
+      free( chunks[ t ].dst );
+      free( chunks[ t ].w );
+   }
+   free( chunks );
+   if( map ) munmap( map, size );
+
+   return g;
+}
+
+/**
+ * @brief Crea un grafo a partir de un archivo de texto con una arista por línea.
+ *
+ * Cada línea tiene la forma "src dst [peso]", con los campos separados por espacios o
+ * tabuladores; src y dst son los datos (llaves) de los vértices. Las líneas vacías y las que
+ * empiezan con '#' o '%' se ignoran. Los vértices se crean en el orden en que aparecen por primera
+ * vez en el archivo.
+ *
+ * El archivo se proyecta en memoria y se divide en pedazos que terminan en un salto de línea;
+ * cada hilo interpreta un pedazo. Las listas de vecinos se construyen de una sola vez con un
+ * ordenamiento por conteo, sin pasar por Graph_AddEdge().
+ *
+ * @note Para que los vértices queden en el orden del archivo, las llaves se numeran (y se
+ * traducen a índices) en una sola pasada secuencial, con una búsqueda en el índice del grafo por
+ * extremo de cada arista. Esa pasada no se reparte entre los hilos y limita cuánto se acelera la
+ * carga con más hilos.
+ *
+ * @param path        Nombre del archivo.
+ * @param type        Tipo del grafo.
+ * @param num_threads Número de hilos; 0 o menos para usar uno por procesador.
+ *
+ * @return Un nuevo grafo, o NULL si el archivo no se pudo leer, tiene una línea mal formada o se
+ * agotó la memoria.
+ */
+Graph* Graph_LoadEdgeList( const char* path, eGraphType type, int num_threads )
+{
+   STATS_PHASE_BEGIN( t );
+   Graph* ret = load_edge_list( path, type, num_threads );
+   STATS_PHASE_END( eStatsPhase_LOAD, t );
+
+   return ret;
+}
+
+
+//----------------------------------------------------------------------
+//                   Strongly connected components
+//----------------------------------------------------------------------
+
+// Renumera las componentes para que no dependan del algoritmo: la componente k es la k-ésima
+// en aparecer al recorrer los vértices por índice (la del vértice 0 es la 0, etc.).
+// max_id: los números de componente de entrada están en [ 0, max_id )
+// tmp: arreglo de |max_id| enteros
+// ret: el número de componentes
+static int canonical_components( int len, int* component, int max_id, int* tmp )
+{
+   for( int c = 0; c < max_id; ++c ) tmp[ c ] = -1;
+
+   int next = 0;
+   for( int v = 0; v < len; ++v )
+   {
+      if( tmp[ component[ v ] ] == -1 ) tmp[ component[ v ] ] = next++;
+      component[ v ] = tmp[ component[ v ] ];
+   }
+
+   return next;
+}
+
+/**
+ * @brief Calcula las componentes fuertemente conexas con el algoritmo de Tarjan.
+ *
+ * Es iterativo (usa una pila de marcos en el heap, como dfs_run()), así que la profundidad sólo
+ * está limitada por la memoria. En un grafo no dirigido las componentes son las componentes
+ * conexas.
+ *
+ * @param g         El grafo. No se modifica.
+ * @param component Recibe el número de componente de cada vértice (por índice). Las componentes
+ * se numeran 0, 1, ... en el orden en que aparece su vértice de menor índice.
+ *
+ * @return El número de componentes, o -1 si se agotó la memoria.
+ */
+int Graph_StronglyConnectedComponents( const Graph* g, int* component )
+{
+   int len = g->len;
+
+   int* order = (int*) malloc( ( len > 0 ? len : 1 ) * sizeof( int ) );  // orden de descubrimiento
+   int* low = (int*) malloc( ( len > 0 ? len : 1 ) * sizeof( int ) );
+   int* stack = (int*) malloc( ( len > 0 ? len : 1 ) * sizeof( int ) );  // vértices sin componente
+   DfsFrame* frames = (DfsFrame*) malloc( ( len > 0 ? len : 1 ) * sizeof( DfsFrame ) );
+
+   if( !order || !low || !stack || !frames )
+   {
+      free( order );
+      free( low );
+      free( stack );
+      free( frames );
+      return -1;
+   }
+
+   // un vértice está en |stack| si ya se descubrió (order != -1) y aún no tiene componente
+   for( int v = 0; v < len; ++v ) order[ v ] = component[ v ] = -1;
+
+   int counter = 0;
+   int stack_len = 0;
+   int num_components = 0;
+
+   for( int root = 0; root < len; ++root )
+   {
+      if( order[ root ] != -1 ) continue;
+
+      int top = 0;
+      order[ root ] = low[ root ] = counter++;
+      stack[ stack_len++ ] = root;
+      frames[ top++ ] = (DfsFrame){ .vertex = root, .pos = neighbors_begin( &g->vertices[ root ] ) };
+
+      while( top > 0 )
+      {
+         DfsFrame* frame = &frames[ top - 1 ];
+         int u = frame->vertex;
+
+         if( !neighbors_end( &g->vertices[ u ], frame->pos ) )
+         {
+            int w = neighbors_get( frame->pos ).index;
+            frame->pos = neighbors_next( frame->pos );
+
+            if( order[ w ] == -1 )
+            {
+               order[ w ] = low[ w ] = counter++;
+               stack[ stack_len++ ] = w;
+               frames[ top++ ] = (DfsFrame){ .vertex = w, .pos = neighbors_begin( &g->vertices[ w ] ) };
+               // cada vértice entra una sola vez, así que la pila nunca pasa de |len| marcos
+            }
+            else if( component[ w ] == -1 && order[ w ] < low[ u ] )
+            {
+               low[ u ] = order[ w ];
+            }
+         }
+         else
+         {
+            if( low[ u ] == order[ u ] )
+            {
+               // |u| es la raíz de una componente: son los vértices arriba de él en |stack|
+               int w;
+               do
+               {
+                  w = stack[ --stack_len ];
+                  component[ w ] = num_components;
+               } while( w != u );
+
+               ++num_components;
+            }
+
+            --top;
+            if( top > 0 )
+            {
+               int parent = frames[ top - 1 ].vertex;
+               if( low[ u ] < low[ parent ] ) low[ parent ] = low[ u ];
+            }
+         }
+      }
+   }
+
+   canonical_components( len, component, num_components, order );
+   // |order| ya no se necesita y tiene lugar para |num_components| <= |len| enteros
+
+   free( order );
+   free( low );
+   free( stack );
+   free( frames );
+
+   return num_components;
+}
+
+/**
+ * @brief Devuelve el grafo de componentes (condensación) de |g|.
+ *
+ * Es un grafo dirigido y acíclico con un vértice por componente fuertemente conexa; la llave del
+ * vértice es el número de componente que asigna Graph_StronglyConnectedComponents(). Hay una
+ * arista A -> B si alguna arista de |g| va de un vértice de A a uno de B (A != B); su peso es el
+ * número de aristas de |g| que representa.
+ *
+ * El resultado se guarda en |g| y se reutiliza hasta que se agregue un vértice o una arista a |g|
+ * (o se eliminen duplicados).
+ *
+ * @param g El grafo.
+ *
+ * @return La condensación (pertenece a |g|: no se debe modificar ni liberar), o NULL si se agotó
+ * la memoria.
+ */
+const Graph* Graph_Condensation( Graph* g )
+{
+   if( g->condensation ) return g->condensation;
+
+   int* component = (int*) malloc( ( g->len > 0 ? g->len : 1 ) * sizeof( int ) );
+   if( !component ) return NULL;
+
+   int num_components = Graph_StronglyConnectedComponents( g, component );
+
+   size_t total = 0;
+   for( int v = 0; v < g->len; ++v ) total += neighbors_len( &g->vertices[ v ] );
+
+   BulkEdge* edges = (BulkEdge*) malloc( ( total > 0 ? total : 1 ) * sizeof( BulkEdge ) );
+   BulkEdge* tmp = (BulkEdge*) malloc( ( total > 0 ? total : 1 ) * sizeof( BulkEdge ) );
+   Graph* dag = num_components >= 0 ? Graph_New( num_components > 0 ? num_components : 1, eGraphType_DIRECTED ) : NULL;
+
+   if( !edges || !tmp || !dag )
+   {
+      free( component );
+      free( edges );
+      free( tmp );
+      if( dag ) Graph_Delete( &dag );
+      return NULL;
+   }
+
+   for( int c = 0; c < num_components; ++c ) Graph_AddVertex( dag, c );
+
+   size_t len = 0;
+   for( int v = 0; v < g->len; ++v )
+   {
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &g->vertices[ v ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         int w = NeighborIter_Get( &it ).index;
+
+         if( component[ v ] != component[ w ] )
+         {
+            edges[ len++ ] = (BulkEdge){ .src = component[ v ], .dst = component[ w ], .w = 1.0 };
+         }
+      }
+   }
+
+   int bits = 1;
+   while( bits < 31 && ( 1u << bits ) < (unsigned) num_components ) ++bits;
+
+   BulkEdge* sorted = radix_sort_edges( edges, tmp, len, bits );
+
+   // las aristas entre el mismo par de componentes quedaron juntas: se suman en una sola
+   for( size_t i = 0; i < len; )
+   {
+      size_t j = i;
+      float count = 0.0;
+      while( j < len && sorted[ j ].src == sorted[ i ].src && sorted[ j ].dst == sorted[ i ].dst )
+      {
+         count += sorted[ j ].w;
+         ++j;
+      }
+
+      if( is_new_edge( dag, sorted[ i ].src, sorted[ i ].dst ) )
+      {
+         push_neighbor( dag, &dag->vertices[ sorted[ i ].src ], sorted[ i ].dst, count );
+      }
+
+      i = j;
+   }
+
+   free( component );
+   free( edges );
+   free( tmp );
+
+   g->condensation = dag;
+   return dag;
+}
+
+
+//----------------------------------------------------------------------
+//               Parallel strongly connected components
+//----------------------------------------------------------------------
+
+// Los subproblemas con a lo más estos vértices se resuelven con Tarjan en un solo hilo.
+#define SCC_SEQUENTIAL_CUTOFF 4096
+
+// Los subproblemas con al menos estos vértices se parten antes de repartir el trabajo, y sus
+// recorridos se expanden con todos los hilos, nivel por nivel...
+#define SCC_PARALLEL_SPLIT_MIN ( 1 << 16 )
+
+// ... pero sólo los niveles con al menos estos vértices; los demás los expande el hilo que llama,
+// así que un recorrido largo y angosto no paga por crear hilos en cada nivel.
+#define SCC_PARALLEL_LEVEL_MIN ( 1 << 14 )
+
+/**
+ * @brief Un subproblema: los vértices con part[ v ] == label, que son justamente |verts|.
+ */
+typedef struct
+{
+   int* verts;
+   int len;
+   int label;
+} SccTask;
+
+/**
+ * @brief Cola doble de subproblemas de un hilo. El dueño mete y saca por el final (LIFO); los
+ * demás hilos roban por el principio, donde están los subproblemas más viejos (y más grandes).
+ */
+typedef struct
+{
+   SccTask* items;
+   int head;
+   int tail;
+   int capacity;
+   pthread_mutex_t lock;
+} SccDeque;
+
+/**
+ * @brief Estado compartido por los hilos de Graph_StronglyConnectedComponentsParallel().
+ *
+ * |component|, |part|, |in_count| y |out_count| se leen y escriben con operaciones atómicas. Cada
+ * subproblema tiene una etiqueta propia, y un hilo sólo cambia |part| o |component| de los
+ * vértices de su subproblema, así que comparar part[ w ] con la etiqueta propia basta para saber
+ * si |w| le pertenece.
+ */
+typedef struct
+{
+   const Graph* g;
+   int num_threads;
+
+   int* in_offsets;   ///< transpuesta en CSR, sin lazos: los predecesores de v son
+   int* in_sources;   ///< in_sources[ in_offsets[ v ] ... in_offsets[ v + 1 ] - 1 ]
+
+   int* in_count;     ///< aristas de entrada (sin lazos) desde vértices no recortados
+   int* out_count;    ///< aristas de salida (sin lazos) hacia vértices no recortados
+   int* fill;         ///< siguiente lugar libre de cada vértice al llenar la transpuesta
+
+   int* component;    ///< -1 mientras no tenga componente; si no, algún vértice de la componente
+   int* part;         ///< etiqueta del subproblema al que pertenece cada vértice; -1 si ya terminó
+   int* order;        ///< para Tarjan
+   int* low;
+
+   SccDeque* deques;  ///< una por hilo
+   int64_t pending;   ///< subproblemas en las colas o en proceso
+
+   // recorrido en curso de par_scc_split_parallel()
+   const int* frontier; ///< el nivel actual
+   int pivot;
+   bool backward;     ///< false: part label -> fw_label; true: fw_label -> componente, label -> bw_label
+   int label;
+   int fw_label;
+   int bw_label;
+
+   int next_label;
+   int failed;        ///< distinto de 0 si algún hilo se quedó sin memoria
+} ParScc;
+
+typedef struct
+{
+   ParScc* shared;
+   int id;
+   int begin;         ///< rango de vértices para las fases por rangos (o del nivel actual)
+   int end;
+   IntBuffer found;   ///< vértices que descubrió en el nivel actual
+} ParSccWorker;
+
+static bool SccDeque_Push( SccDeque* dq, SccTask task )
+{
+   pthread_mutex_lock( &dq->lock );
+
+   bool ok = true;
+   if( dq->tail == dq->capacity )
+   {
+      if( dq->head > 0 )
+      {
+         memmove( dq->items, dq->items + dq->head, ( dq->tail - dq->head ) * sizeof( SccTask ) );
+         dq->tail -= dq->head;
+         dq->head = 0;
+      }
+      else
+      {
+         int capacity = dq->capacity ? 2 * dq->capacity : 16;
+         SccTask* items = (SccTask*) realloc( dq->items, capacity * sizeof( SccTask ) );
+         if( items )
+         {
+            dq->items = items;
+            dq->capacity = capacity;
+         }
+         else ok = false;
+      }
+   }
+
+   if( ok ) dq->items[ dq->tail++ ] = task;
+
+   pthread_mutex_unlock( &dq->lock );
+   return ok;
+}
+
+// el dueño saca el subproblema más nuevo; |steal| saca el más viejo
+static bool SccDeque_Pop( SccDeque* dq, SccTask* task, bool steal )
+{
+   pthread_mutex_lock( &dq->lock );
+
+   bool ok = dq->head < dq->tail;
+   if( ok ) *task = steal ? dq->items[ dq->head++ ] : dq->items[ --dq->tail ];
+
+   pthread_mutex_unlock( &dq->lock );
+   return ok;
+}
+
+static int load_int( const int* p )
+{
+   return __atomic_load_n( p, __ATOMIC_RELAXED );
+}
+
+static void store_int( int* p, int value )
+{
+   __atomic_store_n( p, value, __ATOMIC_RELAXED );
+}
+
+// cuenta las aristas de entrada y de salida de cada vértice de su rango
+static void* par_scc_count( void* arg )
+{
+   ParSccWorker* self = (ParSccWorker*) arg;
+   ParScc* s = self->shared;
+
+   bool reverse = Graph_HasReverse( s->g );
+
+   for( int v = self->begin; v < self->end; ++v )
+   {
+      int out = 0;
+
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &s->g->vertices[ v ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         int w = NeighborIter_Get( &it ).index;
+         if( w == v ) continue;
+
+         ++out;
+         if( !reverse ) __atomic_fetch_add( &s->in_count[ w ], 1, __ATOMIC_RELAXED );
+      }
+
+      s->out_count[ v ] = out;
+
+      if( reverse )
+      {
+         // con las listas de entrada cada hilo cuenta sólo sus vértices y no hacen falta atómicos
+         int in = 0;
+         for( NeighborIter_StartIn( &it, s->g, v ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+         {
+            if( NeighborIter_Get( &it ).index != v ) ++in;
+         }
+         s->in_count[ v ] = in;
+      }
+   }
+
+   return NULL;
+}
+
+// llena la transpuesta con las aristas que salen de su rango
+static void* par_scc_fill( void* arg )
+{
+   ParSccWorker* self = (ParSccWorker*) arg;
+   ParScc* s = self->shared;
+
+   if( Graph_HasReverse( s->g ) )
+   {
+      // se copian las listas de entrada: escrituras secuenciales en lugar de dispersas
+      for( int v = self->begin; v < self->end; ++v )
+      {
+         NeighborIter it;
+         for( NeighborIter_StartIn( &it, s->g, v ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+         {
+            int w = NeighborIter_Get( &it ).index;
+            if( w != v ) s->in_sources[ s->fill[ v ]++ ] = w;
+         }
+      }
+
+      return NULL;
+   }
+
+   for( int v = self->begin; v < self->end; ++v )
+   {
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &s->g->vertices[ v ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         int w = NeighborIter_Get( &it ).index;
+         if( w == v ) continue;
+
+         s->in_sources[ __atomic_fetch_add( &s->fill[ w ], 1, __ATOMIC_RELAXED ) ] = v;
+      }
+   }
+
+   return NULL;
+}
+
+// un vértice sin entradas o sin salidas (hacia vértices vivos) es una componente por sí solo
+static void par_scc_trim_one( ParScc* s, int v, IntBuffer* work )
+{
+   int expected = -1;
+   if( __atomic_compare_exchange_n( &s->component[ v ], &expected, v, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+   {
+      if( !IntBuffer_Push( work, v ) ) __atomic_store_n( &s->failed, 1, __ATOMIC_RELAXED );
+   }
+}
+
+// recorta a todos los vértices que no están en un ciclo, empezando por los de su rango, y
+// propaga: al recortar un vértice sus vecinos pierden una arista
+static void* par_scc_trim( void* arg )
+{
+   ParSccWorker* self = (ParSccWorker*) arg;
+   ParScc* s = self->shared;
+   IntBuffer work = { NULL, 0, 0 };
+
+   for( int v = self->begin; v < self->end; ++v )
+   {
+      if( load_int( &s->in_count[ v ] ) == 0 || load_int( &s->out_count[ v ] ) == 0 )
+      {
+         par_scc_trim_one( s, v, &work );
+      }
+
+      while( work.len > 0 )
+      {
+         int u = work.items[ --work.len ];
+
+         NeighborIter it;
+         for( NeighborIter_Start( &it, &s->g->vertices[ u ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+         {
+            int w = NeighborIter_Get( &it ).index;
+            if( w != u && __atomic_sub_fetch( &s->in_count[ w ], 1, __ATOMIC_RELAXED ) == 0 )
+            {
+               par_scc_trim_one( s, w, &work );
+            }
+         }
+
+         for( int i = s->in_offsets[ u ]; i < s->in_offsets[ u + 1 ]; ++i )
+         {
+            int w = s->in_sources[ i ];
+            if( __atomic_sub_fetch( &s->out_count[ w ], 1, __ATOMIC_RELAXED ) == 0 )
+            {
+               par_scc_trim_one( s, w, &work );
+            }
+         }
+      }
+   }
+
+   free( work.items );
+   return NULL;
+}
+
+// Tarjan restringido a los vértices del subproblema
+static bool par_scc_tarjan( ParScc* s, const SccTask* task )
+{
+   int* stack = (int*) malloc( task->len * sizeof( int ) );
+   DfsFrame* frames = (DfsFrame*) malloc( task->len * sizeof( DfsFrame ) );
+   if( !stack || !frames )
+   {
+      free( stack );
+      free( frames );
+      return false;
+   }
+
+   const Vertex* vertices = s->g->vertices;
+   int label = task->label;
+
+   for( int i = 0; i < task->len; ++i ) s->order[ task->verts[ i ] ] = -1;
+
+   int counter = 0;
+   int stack_len = 0;
+
+   for( int i = 0; i < task->len; ++i )
+   {
+      int root = task->verts[ i ];
+      if( s->order[ root ] != -1 ) continue;
+
+      int top = 0;
+      s->order[ root ] = s->low[ root ] = counter++;
+      stack[ stack_len++ ] = root;
+      frames[ top++ ] = (DfsFrame){ .vertex = root, .pos = neighbors_begin( &vertices[ root ] ) };
+
+      while( top > 0 )
+      {
+         DfsFrame* frame = &frames[ top - 1 ];
+         int u = frame->vertex;
+
+         if( !neighbors_end( &vertices[ u ], frame->pos ) )
+         {
+            int w = neighbors_get( frame->pos ).index;
+            frame->pos = neighbors_next( frame->pos );
+
+            if( load_int( &s->part[ w ] ) != label ) continue;
+            // |w| es de otro subproblema (o ya terminó)
+
+            if( s->order[ w ] == -1 )
+            {
+               s->order[ w ] = s->low[ w ] = counter++;
+               stack[ stack_len++ ] = w;
+               frames[ top++ ] = (DfsFrame){ .vertex = w, .pos = neighbors_begin( &vertices[ w ] ) };
+            }
+            else if( load_int( &s->component[ w ] ) == -1 && s->order[ w ] < s->low[ u ] )
+            {
+               s->low[ u ] = s->order[ w ];
+            }
+         }
+         else
+         {
+            if( s->low[ u ] == s->order[ u ] )
+            {
+               int w;
+               do
+               {
+                  w = stack[ --stack_len ];
+                  store_int( &s->component[ w ], u );
+               } while( w != u );
+            }
+
+            --top;
+            if( top > 0 )
+            {
+               int parent = frames[ top - 1 ].vertex;
+               if( s->low[ u ] < s->low[ parent ] ) s->low[ parent ] = s->low[ u ];
+            }
+         }
+      }
+   }
+
+   for( int i = 0; i < task->len; ++i ) store_int( &s->part[ task->verts[ i ] ], -1 );
+
+   free( stack );
+   free( frames );
+   return true;
+}
+
+// Reparte a los vértices del subproblema que quedaron con alguna de las tres etiquetas en
+// subproblemas nuevos. Los que tienen al menos SCC_PARALLEL_SPLIT_MIN vértices van a |big| (si no
+// es NULL); los demás, a |small|, y cuentan como pendientes.
+static bool par_scc_partition( ParScc* s, const SccTask* task, const int labels[ 3 ], SccDeque* small, SccDeque* big )
+{
+   int counts[ 3 ] = { 0, 0, 0 };
+   for( int i = 0; i < task->len; ++i )
+   {
+      int part = load_int( &s->part[ task->verts[ i ] ] );
+      for( int k = 0; k < 3; ++k ) counts[ k ] += part == labels[ k ];
+   }
+
+   for( int k = 0; k < 3; ++k )
+   {
+      if( counts[ k ] == 0 ) continue;
+
+      SccTask child = { (int*) malloc( counts[ k ] * sizeof( int ) ), 0, labels[ k ] };
+      if( !child.verts ) return false;
+
+      for( int i = 0; i < task->len; ++i )
+      {
+         if( load_int( &s->part[ task->verts[ i ] ] ) == labels[ k ] ) child.verts[ child.len++ ] = task->verts[ i ];
+      }
+
+      bool ok;
+      if( big && child.len >= SCC_PARALLEL_SPLIT_MIN ) ok = SccDeque_Push( big, child );
+      else
+      {
+         __atomic_fetch_add( &s->pending, 1, __ATOMIC_RELAXED );
+         ok = SccDeque_Push( small, child );
+         if( !ok ) __atomic_fetch_sub( &s->pending, 1, __ATOMIC_RELAXED );
+      }
+
+      if( !ok )
+      {
+         free( child.verts );
+         return false;
+      }
+   }
+
+   return true;
+}
+
+// Forward-backward: los vértices a los que llega el pivote y que llegan a él forman su
+// componente; lo demás se parte en tres subproblemas independientes.
+static bool par_scc_split( ParScc* s, int id, const SccTask* task )
+{
+   int* queue = (int*) malloc( task->len * sizeof( int ) );
+   if( !queue ) return false;
+
+   const Vertex* vertices = s->g->vertices;
+   int label = task->label;
+   int fw_label = __atomic_fetch_add( &s->next_label, 2, __ATOMIC_RELAXED );
+   int bw_label = fw_label + 1;
+
+   int pivot = task->verts[ 0 ];
+
+   // hacia adelante: part = fw_label
+   int len = 0;
+   store_int( &s->part[ pivot ], fw_label );
+   queue[ len++ ] = pivot;
+   for( int front = 0; front < len; ++front )
+   {
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &vertices[ queue[ front ] ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         int w = NeighborIter_Get( &it ).index;
+         if( load_int( &s->part[ w ] ) == label )
+         {
+            store_int( &s->part[ w ], fw_label );
+            queue[ len++ ] = w;
+         }
+      }
+   }
+
+   // hacia atrás: los que ya estaban marcados forman la componente; los demás, part = bw_label
+   len = 0;
+   store_int( &s->part[ pivot ], -1 );
+   store_int( &s->component[ pivot ], pivot );
+   queue[ len++ ] = pivot;
+   for( int front = 0; front < len; ++front )
+   {
+      int v = queue[ front ];
+      for( int i = s->in_offsets[ v ]; i < s->in_offsets[ v + 1 ]; ++i )
+      {
+         int u = s->in_sources[ i ];
+         int part = load_int( &s->part[ u ] );
+
+         if( part == fw_label )
+         {
+            store_int( &s->part[ u ], -1 );
+            store_int( &s->component[ u ], pivot );
+            queue[ len++ ] = u;
+         }
+         else if( part == label )
+         {
+            store_int( &s->part[ u ], bw_label );
+            queue[ len++ ] = u;
+         }
+      }
+   }
+
+   free( queue );
+
+   int labels[ 3 ] = { fw_label, bw_label, label };
+   return par_scc_partition( s, task, labels, &s->deques[ id ], NULL );
+}
+
+// marca a |w| si le toca en el recorrido en curso y lo agrega a |out|; varios hilos pueden
+// visitar al mismo vértice a la vez, pero sólo uno gana la comparación e intercambio
+static void par_scc_visit( ParScc* s, int w, IntBuffer* out )
+{
+   int expected = s->backward ? s->fw_label : s->label;
+   bool found = __atomic_compare_exchange_n( &s->part[ w ], &expected, s->backward ? -1 : s->fw_label,
+                                             false, __ATOMIC_RELAXED, __ATOMIC_RELAXED );
+
+   if( found && s->backward ) store_int( &s->component[ w ], s->pivot );
+   // |w| llega al pivote y el pivote llega a |w|
+
+   if( !found && s->backward && expected == s->label )
+   {
+      found = __atomic_compare_exchange_n( &s->part[ w ], &expected, s->bw_label,
+                                           false, __ATOMIC_RELAXED, __ATOMIC_RELAXED );
+   }
+
+   if( found && !IntBuffer_Push( out, w ) ) __atomic_store_n( &s->failed, 1, __ATOMIC_RELAXED );
+}
+
+static void par_scc_expand( ParScc* s, int v, IntBuffer* out )
+{
+   if( s->backward )
+   {
+      for( int i = s->in_offsets[ v ]; i < s->in_offsets[ v + 1 ]; ++i ) par_scc_visit( s, s->in_sources[ i ], out );
+   }
+   else
+   {
+      NeighborIter it;
+      for( NeighborIter_Start( &it, &s->g->vertices[ v ] ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+      {
+         par_scc_visit( s, NeighborIter_Get( &it ).index, out );
+      }
+   }
+}
+
+// expande su tramo [ begin, end ) del nivel actual
+static void* par_scc_level( void* arg )
+{
+   ParSccWorker* self = (ParSccWorker*) arg;
+
+   self->found.len = 0;
+   for( int i = self->begin; i < self->end; ++i ) par_scc_expand( self->shared, self->shared->frontier[ i ], &self->found );
+
+   return NULL;
+}
+
+// recorre en amplitud desde el pivote, que ya está marcado; |frontier| tiene lugar para todos los
+// vértices del subproblema
+static bool par_scc_reach( ParScc* s, ParSccWorker* workers, int* frontier )
+{
+   s->frontier = frontier;
+   frontier[ 0 ] = s->pivot;
+   int len = 1;
+
+   while( len > 0 && !s->failed )
+   {
+      int threads = len >= SCC_PARALLEL_LEVEL_MIN ? s->num_threads : 1;
+
+      for( int t = 0; t < threads; ++t )
+      {
+         workers[ t ].begin = (int) ( (int64_t) len * t / threads );
+         workers[ t ].end = (int) ( (int64_t) len * ( t + 1 ) / threads );
+      }
+
+      if( threads > 1 ) parallel_run( threads, par_scc_level, workers, sizeof( ParSccWorker ) );
+      else par_scc_level( &workers[ 0 ] );
+
+      // el siguiente nivel reemplaza al actual, que ya no se necesita
+      len = 0;
+      for( int t = 0; t < threads; ++t )
+      {
+         if( workers[ t ].found.len == 0 ) continue;
+
+         memcpy( frontier + len, workers[ t ].found.items, workers[ t ].found.len * sizeof( int ) );
+         len += workers[ t ].found.len;
+      }
+   }
+
+   return !s->failed;
+}
+
+// Como par_scc_split(), pero los dos recorridos usan a todos los hilos. Se usa antes de repartir
+// el trabajo, para los subproblemas grandes (típicamente, el que contiene a la componente gigante).
+static bool par_scc_split_parallel( ParScc* s, ParSccWorker* workers, const SccTask* task, SccDeque* big )
+{
+   int* frontier = (int*) malloc( task->len * sizeof( int ) );
+   if( !frontier ) return false;
+
+   // como pivote, el vértice con más aristas de entrada por salida: es el que tiene más
+   // probabilidad de estar en una componente grande
+   int pivot = task->verts[ 0 ];
+   int64_t best = -1;
+   for( int i = 0; i < task->len; ++i )
+   {
+      int v = task->verts[ i ];
+      int64_t score = (int64_t) s->in_count[ v ] * s->out_count[ v ];
+      if( score > best )
+      {
+         best = score;
+         pivot = v;
+      }
+   }
+
+   s->pivot = pivot;
+   s->label = task->label;
+   s->fw_label = __atomic_fetch_add( &s->next_label, 2, __ATOMIC_RELAXED );
+   s->bw_label = s->fw_label + 1;
+
+   s->backward = false;
+   store_int( &s->part[ pivot ], s->fw_label );
+   bool ok = par_scc_reach( s, workers, frontier );
+
+   if( ok )
+   {
+      s->backward = true;
+      store_int( &s->part[ pivot ], -1 );
+      store_int( &s->component[ pivot ], pivot );
+      ok = par_scc_reach( s, workers, frontier );
+   }
+
+   free( frontier );
+
+   int labels[ 3 ] = { s->fw_label, s->bw_label, s->label };
+   return ok && par_scc_partition( s, task, labels, &s->deques[ 0 ], big );
+}
+
+// toma subproblemas de su cola o, si está vacía, los roba de las de los demás
+static void* par_scc_worker( void* arg )
+{
+   ParSccWorker* self = (ParSccWorker*) arg;
+   ParScc* s = self->shared;
+
+   while( true )
+   {
+      SccTask task;
+      bool found = SccDeque_Pop( &s->deques[ self->id ], &task, false );
+
+      for( int k = 1; k < s->num_threads && !found; ++k )
+      {
+         found = SccDeque_Pop( &s->deques[ ( self->id + k ) % s->num_threads ], &task, true );
+      }
+
+      if( found )
+      {
+         if( !__atomic_load_n( &s->failed, __ATOMIC_RELAXED ) )
+         {
+            bool ok = task.len <= SCC_SEQUENTIAL_CUTOFF ? par_scc_tarjan( s, &task ) : par_scc_split( s, self->id, &task );
+            if( !ok ) __atomic_store_n( &s->failed, 1, __ATOMIC_RELAXED );
+         }
+         // si algún hilo falló, los subproblemas que quedan sólo se descartan
+
+         free( task.verts );
+         __atomic_fetch_sub( &s->pending, 1, __ATOMIC_ACQ_REL );
+      }
+      else if( __atomic_load_n( &s->pending, __ATOMIC_ACQUIRE ) == 0 ) break;
+      else sched_yield();
+   }
+
+   return NULL;
+}
+
+/**
+ * @brief Calcula las componentes fuertemente conexas con varios hilos.
+ *
+ * Primero recorta (en paralelo) a los vértices que no están en ningún ciclo; luego aplica
+ * forward-backward: las componentes se separan en subproblemas independientes que los hilos se
+ * reparten robándose trabajo, y los subproblemas pequeños se resuelven con Tarjan. Los
+ * subproblemas grandes (como el que contiene a una componente gigante) se parten antes, con
+ * recorridos en amplitud en los que todos los hilos expanden cada nivel ancho. Las aristas de
+ * entrada se obtienen de una transpuesta que se construye al momento; si el grafo mantiene sus
+ * listas de entrada (Graph_SetReverse()) se copia de ellas, lo que es bastante más barato.
+ *
+ * Con un solo hilo, o con a lo más SCC_SEQUENTIAL_CUTOFF vértices, simplemente se llama a
+ * Graph_StronglyConnectedComponents().
+ *
+ * @note Construir la transpuesta, recortar y los recorridos hacia adelante y hacia atrás cuestan
+ * varias veces lo que Tarjan (del orden de 3x con un solo núcleo), así que sólo conviene con
+ * varios núcleos. Los niveles angostos (como los de un grafo de diámetro grande) se expanden
+ * en un solo hilo.
+ *
+ * @param g           El grafo. No se modifica; no debe cambiar mientras dure la llamada.
+ * @param num_threads Número de hilos; 0 o menos para usar uno por procesador.
+ * @param component   Como en Graph_StronglyConnectedComponents(), con la misma numeración.
+ *
+ * @return El número de componentes, o -1 si se agotó la memoria.
+ */
+int Graph_StronglyConnectedComponentsParallel( const Graph* g, int num_threads, int* component )
+{
+   num_threads = default_num_threads( num_threads );
+
+   int len = g->len;
+   if( num_threads == 1 || len <= SCC_SEQUENTIAL_CUTOFF ) return Graph_StronglyConnectedComponents( g, component );
+   // con un hilo, o con un grafo pequeño, lo que cuestan la transpuesta y los recorridos no se
+   // recupera
+
+   size_t n = (size_t) len;
+   ParScc s = { .g = g, .num_threads = num_threads, .component = component, .next_label = 1 };
+
+   s.in_offsets = (int*) calloc( n + 1, sizeof( int ) );
+   s.in_count = (int*) calloc( n, sizeof( int ) );
+   s.out_count = (int*) malloc( n * sizeof( int ) );
+   s.fill = (int*) malloc( n * sizeof( int ) );
+   s.part = (int*) malloc( n * sizeof( int ) );
+   s.order = (int*) malloc( n * sizeof( int ) );
+   s.low = (int*) malloc( n * sizeof( int ) );
+   s.deques = (SccDeque*) calloc( num_threads, sizeof( SccDeque ) );
+   ParSccWorker* workers = (ParSccWorker*) malloc( num_threads * sizeof( ParSccWorker ) );
+
+   // los candados y los hilos se inicializan en cuanto existen, para que la limpieza del final
+   // sea válida aunque falle cualquier otra reserva
+   if( s.deques )
+   {
+      for( int t = 0; t < num_threads; ++t ) pthread_mutex_init( &s.deques[ t ].lock, NULL );
+   }
+
+   if( workers )
+   {
+      for( int t = 0; t < num_threads; ++t )
+      {
+         workers[ t ] = (ParSccWorker){ .shared = &s, .id = t,
+                                        .begin = (int) ( n * t / num_threads ),
+                                        .end = (int) ( n * ( t + 1 ) / num_threads ) };
+      }
+   }
+
+   SccDeque big = { .items = NULL };
+   pthread_mutex_init( &big.lock, NULL );
+
+   bool ok = s.in_offsets && s.in_count && s.out_count && s.fill && s.part && s.order && s.low && s.deques && workers;
+
+   if( ok )
+   {
+      for( int v = 0; v < len; ++v ) component[ v ] = -1;
+
+      // la transpuesta
+      parallel_run( num_threads, par_scc_count, workers, sizeof( ParSccWorker ) );
+
+      for( int v = 0; v < len; ++v ) s.in_offsets[ v + 1 ] = s.in_offsets[ v ] + s.in_count[ v ];
+      memcpy( s.fill, s.in_offsets, n * sizeof( int ) );
+
+      s.in_sources = (int*) malloc( ( s.in_offsets[ len ] > 0 ? s.in_offsets[ len ] : 1 ) * sizeof( int ) );
+      ok = s.in_sources;
+   }
+
+   if( ok )
+   {
+      parallel_run( num_threads, par_scc_fill, workers, sizeof( ParSccWorker ) );
+
+      parallel_run( num_threads, par_scc_trim, workers, sizeof( ParSccWorker ) );
+      ok = !s.failed;
+   }
+
+   if( ok )
+   {
+      // lo que no se recortó es el primer subproblema
+      SccTask task = { s.fill, 0, 0 };
+      for( int v = 0; v < len; ++v )
+      {
+         s.part[ v ] = component[ v ] == -1 ? 0 : -1;
+         if( component[ v ] == -1 ) task.verts[ task.len++ ] = v;
+      }
+      s.fill = NULL;
+      // el arreglo |fill| ya no se necesita; ahora le pertenece al subproblema
+
+      if( task.len >= SCC_PARALLEL_SPLIT_MIN ) ok = SccDeque_Push( &big, task );
+      else if( task.len > 0 )
+      {
+         s.pending = 1;
+         ok = SccDeque_Push( &s.deques[ 0 ], task );
+      }
+      else free( task.verts );
+
+      if( !ok ) free( task.verts );
+   }
+
+   // los subproblemas grandes se parten con todos los hilos antes de repartir el trabajo
+   SccTask big_task;
+   while( ok && SccDeque_Pop( &big, &big_task, false ) )
+   {
+      ok = par_scc_split_parallel( &s, workers, &big_task, &big );
+      free( big_task.verts );
+   }
+   while( SccDeque_Pop( &big, &big_task, false ) ) free( big_task.verts );
+
+   if( ok && s.pending > 0 )
+   {
+      parallel_run( num_threads, par_scc_worker, workers, sizeof( ParSccWorker ) );
+      ok = !s.failed;
+   }
+   else if( s.pending > 0 )
+   {
+      SccTask task;
+      for( int t = 0; t < num_threads; ++t )
+      {
+         while( SccDeque_Pop( &s.deques[ t ], &task, false ) ) free( task.verts );
+      }
+   }
+
+   int num_components = ok ? canonical_components( len, component, len, s.order ) : -1;
+
+   if( s.deques )
+   {
+      for( int t = 0; t < num_threads; ++t )
+      {
+         free( s.deques[ t ].items );
+         pthread_mutex_destroy( &s.deques[ t ].lock );
+      }
+   }
+
+   if( workers )
+   {
+      for( int t = 0; t < num_threads; ++t ) free( workers[ t ].found.items );
+   }
+   free( big.items );
+   pthread_mutex_destroy( &big.lock );
+
+   free( s.in_offsets );
+   free( s.in_sources );
+   free( s.in_count );
+   free( s.out_count );
+   free( s.fill );
+   free( s.part );
+   free( s.order );
+   free( s.low );
+   free( s.deques );
+   free( workers );
+
+   return num_components;
+}
@@ -0,0 +1,366 @@
+#ifndef  GRAPH_INC
+#define  GRAPH_INC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "List.h"
+#include "Queue.h"
+#include "IntMap.h"
+#include "EdgeSet.h"
+#include "DataVec.h"
+
+/**
+ * @file
+ * @brief Grafos (listas de adyacencia), sus recorridos y su representación congelada (CSR).
+ */
+
+// Con 1 los vecinos de cada vértice se guardan en un arreglo contiguo (DataVec) con búfer interno
+// para grados pequeños; con 0 se guardan en una lista ligada (List) cuyos nodos salen de una arena.
+#ifndef VERTEX_USE_SMALLVEC
+#define VERTEX_USE_SMALLVEC 0
+#endif
+
+// Aunque en este ejemplo estamos usando tipos básicos, vamos a usar al alias |Item| para resaltar
+// aquellos lugares donde estamos hablando de DATOS y no de índices.
+typedef int Item;
+
+/**
+* @brief Colores para
+*/
+typedef enum
+{
+   WHITE, ///< vértice
+   GRAY,  ///< vértice
+   BLACK, ///< vértice
+} eGraphColors;
+
+
+//----------------------------------------------------------------------
+//                            Vertex stuff:
+//----------------------------------------------------------------------
+
+/**
+ * @brief Estado de los recorridos, guardado por columnas: un arreglo denso por campo, indexado
+ * por el índice del vértice.
+ *
+ * Así un recorrido que sólo consulta el color lee un byte por vértice en lugar de arrastrar a
+ * todo el vértice a la caché.
+ *
+ * Los campos de un vértice sólo son válidos si stamp[ v ] == epoch; si no, el vértice se
+ * considera WHITE, sin predecesor, con tiempos 0 y distancia -1. Así, para empezar una consulta
+ * nueva basta con incrementar |epoch|, sin recorrer a todos los vértices.
+ */
+typedef struct
+{
+   uint8_t* color;          ///< eGraphColors de cada vértice
+   int32_t* predecessor;
+   int32_t* discovery_time;
+   int32_t* finish_time;
+   int32_t* distance;
+
+   uint32_t* stamp;         ///< época en la que se escribió por última vez cada vértice
+   uint32_t epoch;          ///< época de la consulta actual; nunca es 0
+
+   int capacity;            ///< número de elementos de cada arreglo
+} VertexState;
+
+// Una lista de vecinos: los de salida de cada vértice y, si se mantienen, los de entrada.
+#if VERTEX_USE_SMALLVEC
+typedef DataVec NeighborList;
+#else
+typedef List* NeighborList;
+#endif
+
+/**
+ * @brief Declara lo que es un vértice.
+ *
+ * Los campos que cambian en cada recorrido (color, predecesor, tiempos y distancia) no viven
+ * aquí, sino en el contexto de recorrido del grafo.
+ */
+typedef struct
+{
+   Item data;
+   int index;            ///< posición del vértice en la lista de vértices
+   NeighborList neighbors;
+   int out_degree;       ///< número de aristas que salen del vértice (el largo de |neighbors|)
+   int in_degree;        ///< número de aristas que llegan al vértice
+
+   VertexState* state;   ///< estado de los recorridos del grafo al que pertenece
+} Vertex;
+
+// Posición en la lista de vecinos que no depende del cursor del vértice; la usan los recorridos
+// internos para no pisar al cursor.
+#if VERTEX_USE_SMALLVEC
+typedef const Data* NeighborPos;
+#else
+typedef const Node* NeighborPos;
+#endif
+
+/**
+ * @brief Iterador sobre los vecinos de un vértice.
+ *
+ * A diferencia de Vertex_Start(), Vertex_Next() y Vertex_End(), no usa (ni modifica) al cursor del
+ * vértice: todo su estado vive en el propio iterador, que normalmente está en la pila. Por eso se
+ * pueden recorrer los vecinos de un mismo vértice desde recorridos anidados o desde varios hilos a
+ * la vez, siempre que nadie modifique al grafo mientras tanto.
+ *
+ * Ejemplo
+ * @code
+   NeighborIter it;
+   for( NeighborIter_Start( &it, v ); !NeighborIter_End( &it ); NeighborIter_Next( &it ) )
+   {
+      int index = NeighborIter_Get( &it ).index;
+
+      // ...
+   }
+   @endcode
+ */
+typedef struct
+{
+   const NeighborList* list;
+   NeighborPos pos;
+} NeighborIter;
+
+bool Vertex_HasNeighbors( const Vertex* v );
+void NeighborIter_Start( NeighborIter* it, const Vertex* v );
+bool NeighborIter_End( const NeighborIter* it );
+void NeighborIter_Next( NeighborIter* it );
+Data NeighborIter_Get( const NeighborIter* it );
+void Vertex_Start( Vertex* v );
+void Vertex_Next( Vertex* v );
+bool Vertex_End( const Vertex* v );
+Data Vertex_GetNeighborIndex( const Vertex* v );
+void Vertex_SetColor( Vertex* v, eGraphColors color );
+eGraphColors Vertex_GetColor( Vertex* v );
+int Vertex_GetData( const Vertex* v );
+void Vertex_SetPredecessor( Vertex* v, int predecessor_idx );
+int Vertex_GetPredecessor( const Vertex* v );
+void Vertex_SetDiscovery_time( Vertex* v, int time );
+int Vertex_GetDiscovery_time( const Vertex* v );
+void Vertex_SetFinish_time( Vertex* v, int time );
+int Vertex_GetFinish_time( const Vertex* v );
+void Vertex_SetDistance( Vertex* v, int distance );
+int Vertex_GetDistance( const Vertex* v );
+
+
+//----------------------------------------------------------------------
+//                       Traversal context stuff:
+//----------------------------------------------------------------------
+
+/**
+ * @brief Marco de la pila explícita de la búsqueda en profundidad: el vértice y el siguiente
+ * vecino por revisar.
+ */
+typedef struct
+{
+   int vertex;
+   NeighborPos pos;
+} DfsFrame;
+
+/**
+ * @brief Todo el estado de una consulta (recorrido) sobre un grafo.
+ *
+ * Los recorridos que reciben un contexto no modifican al grafo, así que varios hilos pueden
+ * atender consultas sobre el mismo grafo sin candados, cada uno con su propio contexto. Un
+ * contexto se puede reutilizar en muchas consultas: sólo pide memoria cuando el grafo creció.
+ */
+typedef struct
+{
+   VertexState state;  ///< color, predecesor, tiempos y distancia de cada vértice
+
+   DfsFrame* stack;    ///< pila de la búsqueda en profundidad
+   int stack_capacity;
+
+   int* output;        ///< vértices (índices) en el orden en que el recorrido los produjo
+   int output_len;
+
+   int time;           ///< el reloj de la búsqueda en profundidad
+} TraversalContext;
+
+TraversalContext* TraversalContext_New();
+void TraversalContext_Delete( TraversalContext** ctx );
+const int* TraversalContext_GetOutput( const TraversalContext* ctx );
+int TraversalContext_GetOutputLen( const TraversalContext* ctx );
+eGraphColors TraversalContext_GetColor( const TraversalContext* ctx, int vertex_idx );
+int TraversalContext_GetPredecessor( const TraversalContext* ctx, int vertex_idx );
+int TraversalContext_GetDiscovery_time( const TraversalContext* ctx, int vertex_idx );
+int TraversalContext_GetFinish_time( const TraversalContext* ctx, int vertex_idx );
+int TraversalContext_GetDistance( const TraversalContext* ctx, int vertex_idx );
+
+
+//----------------------------------------------------------------------
+//                             Graph stuff:
+//----------------------------------------------------------------------
+
+/** Tipo del grafo.
+ */
+typedef enum
+{
+   eGraphType_UNDIRECTED, ///< grafo no dirigido
+   eGraphType_DIRECTED    ///< grafo dirigido (digraph)
+} eGraphType;
+
+/** Cuándo se rechazan las aristas duplicadas.
+ */
+typedef enum
+{
+   eGraphDedup_EAGER,   ///< al insertar cada arista (por omisión)
+   eGraphDedup_DEFERRED ///< nunca al insertar; se eliminan después con Graph_Deduplicate()
+} eGraphDedup;
+
+/**
+ * @brief Declara lo que es un grafo.
+ */
+typedef struct Graph
+{
+   Vertex* vertices; ///< Lista de vértices
+   int size;         ///< Capacidad de la lista de vértices; crece conforme se agregan vértices
+
+   /**
+    * Número de vértices actualmente en el grafo.
+    * Como esta versión no borra vértices, lo podemos usar como índice en la
+    * función de inserción
+    */
+   int len;  
+
+   eGraphType type; ///< tipo del grafo, UNDIRECTED o DIRECTED
+
+   IntMap* index;   ///< índice de llave (el |dato|) a índice en la lista de vértices
+
+   TraversalContext ctx; ///< contexto de dfs_topol() y de las funciones Vertex_Get/Set*()
+
+   NodePool* pool;    ///< arena de donde salen los nodos de todas las listas de vecinos
+
+   EdgeSet* edges;    ///< aristas existentes (por índices); NULL en modo DEFERRED
+   eGraphDedup dedup; ///< cuándo se rechazan las aristas duplicadas
+
+   /**
+    * Vecinos de entrada de cada vértice (los índices de los vértices de origen), paralelo a
+    * |vertices|. NULL si no se mantienen (ver Graph_SetReverse()); un grafo no dirigido nunca los
+    * guarda porque coinciden con los de salida.
+    */
+   NeighborList* in_neighbors;
+
+   struct Graph* condensation; ///< caché de Graph_Condensation(); NULL si hay que reconstruirla
+} Graph;
+
+Graph* Graph_New( int size, eGraphType type );
+void Graph_Delete( Graph** g );
+bool Graph_Reserve( Graph* g, int capacity );
+void Graph_ShrinkToFit( Graph* g );
+void Graph_Print( Graph* g, int depth );
+bool Graph_AddVertex( Graph* g, int data );
+int Graph_GetSize( Graph* g );
+bool Graph_AddEdge( Graph* g, int start, int finish );
+bool Graph_AddEdges( Graph* g, const int* src, const int* dst, const float* w, size_t n );
+int Graph_GetLen( const Graph* g );
+bool Graph_Deduplicate( Graph* g );
+bool Graph_SetDedup( Graph* g, eGraphDedup mode );
+bool Graph_SetReverse( Graph* g, bool enable );
+bool Graph_HasReverse( const Graph* g );
+int Graph_InDegree( const Graph* g, int vertex_idx );
+void NeighborIter_StartIn( NeighborIter* it, const Graph* g, int vertex_idx );
+Item Graph_GetDataByIndex( const Graph* g, int vertex_idx );
+Vertex* Graph_GetVertexByIndex( const Graph* g, int vertex_idx );
+Vertex* Graph_GetVertexByKey( const Graph* g, Item key );
+int Graph_Size( Graph* g );
+
+
+//----------------------------------------------------------------------
+//                      Frozen (CSR) graph stuff:
+//----------------------------------------------------------------------
+
+/**
+ * @brief Fotografía inmutable de un grafo en formato CSR (compressed sparse row).
+ *
+ * Los vecinos del vértice i están en targets[ offsets[ i ] ] ... targets[ offsets[ i + 1 ] - 1 ],
+ * en el mismo orden en el que aparecen en su lista de vecinos. Los pesos viven en un arreglo
+ * paralelo para que los recorridos, que sólo necesitan los índices, lean 4 bytes por arista.
+ */
+typedef struct
+{
+   int*   offsets; ///< len + 1 entradas
+   int*   targets; ///< índices de los vecinos; offsets[ len ] entradas
+   float* weights; ///< peso de cada arista, paralelo a |targets|
+   Item*  keys;    ///< el dato de cada vértice
+
+   int len;        ///< número de vértices
+   int edges;      ///< número de aristas (un grafo no dirigido guarda ambos sentidos)
+
+   eGraphType type;
+
+   void* map;      ///< si no es NULL, los arreglos apuntan a este archivo proyectado en memoria
+   size_t map_len;
+} FrozenGraph;
+
+FrozenGraph* Graph_Freeze( const Graph* g );
+void FrozenGraph_Delete( FrozenGraph** fg );
+int FrozenGraph_GetLen( const FrozenGraph* fg );
+Item FrozenGraph_GetDataByIndex( const FrozenGraph* fg, int vertex_idx );
+int FrozenGraph_Degree( const FrozenGraph* fg, int vertex_idx );
+FrozenGraph* FrozenGraph_Transpose( const FrozenGraph* fg );
+int FrozenGraph_Dfs( const FrozenGraph* fg, int start, int* pred, int* discovery, int* finish, int* post_order );
+int FrozenGraph_Bfs( const FrozenGraph* fg, int start, int* distance, int* pred, int* order );
+int FrozenGraph_DfsTopol( const FrozenGraph* fg, int start, int* order );
+bool FrozenGraph_Save( const FrozenGraph* fg, const char* path, bool with_weights );
+bool Graph_Save( const Graph* g, const char* path, bool with_weights );
+FrozenGraph* Graph_Load( const char* path );
+bool FrozenGraph_Validate( const FrozenGraph* fg );
+
+
+//----------------------------------------------------------------------
+//                             Traversals:
+//----------------------------------------------------------------------
+
+void dfs_topol_traverse( Graph* g, Vertex* v, int* pTiempo, Queue* listado);
+int Graph_Dfs( const Graph* g, int start, TraversalContext* ctx );
+int Graph_Bfs( const Graph* g, int start, TraversalContext* ctx );
+int Graph_BfsDirectionOptimizing( const Graph* g, int start, TraversalContext* ctx );
+int Graph_ExtractPath( const TraversalContext* ctx, int target, int* out );
+void dfs_topol( Graph* g, int start );
+
+
+//----------------------------------------------------------------------
+//                          Topological sort:
+//----------------------------------------------------------------------
+
+/** Algoritmo para el ordenamiento topológico.
+ */
+typedef enum
+{
+   eTopoSort_DFS,  ///< inverso del orden posterior de la búsqueda en profundidad
+   eTopoSort_KAHN, ///< eliminación de vértices con grado de entrada 0
+} eTopoSortMethod;
+
+/** Resultado del ordenamiento topológico.
+ */
+typedef enum
+{
+   eTopoSort_OK,    ///< el grafo es acíclico; el orden está completo
+   eTopoSort_CYCLE, ///< el grafo tiene (al menos) un ciclo
+   eTopoSort_NOMEM, ///< se agotó la memoria
+} eTopoSortResult;
+
+eTopoSortResult Graph_TopologicalSort( const Graph* g, eTopoSortMethod method, int* order, int* cycle, int* cycle_len );
+eTopoSortResult Graph_TopologicalSortParallel( const Graph* g, int num_threads, int* order, int* level, int* cycle, int* cycle_len );
+
+
+//----------------------------------------------------------------------
+//                            Bulk loading:
+//----------------------------------------------------------------------
+
+Graph* Graph_LoadEdgeList( const char* path, eGraphType type, int num_threads );
+
+
+//----------------------------------------------------------------------
+//                   Strongly connected components:
+//----------------------------------------------------------------------
+
+int Graph_StronglyConnectedComponents( const Graph* g, int* component );
+int Graph_StronglyConnectedComponentsParallel( const Graph* g, int num_threads, int* component );
+const Graph* Graph_Condensation( Graph* g );
+
+#endif   /* ----- #ifndef GRAPH_INC  ----- */
@@ -0,0 +1,125 @@
+#include "IntMap.h"
+#include "Stats.h"
+
+#include <stdint.h>
+
+// La carga se mantiene por debajo de 1/2 para que las cadenas de prueba sean cortas.
+#define INTMAP_MIN_BITS 4
+
+static size_t slot_of( const IntMap* map, int key )
+{
+   // hash multiplicativo de Fibonacci: los bits altos del producto dependen de toda la llave (los
+   // bajos sólo de los bits bajos de la llave, así que llaves múltiplos de 2^k chocarían)
+   return (size_t) ( ( (uint64_t) (uint32_t) key * 0x9E3779B97F4A7C15ull ) >> ( 64 - map->bits ) );
+}
+
+static IntMapSlot* new_slots( size_t capacity )
+{
+   IntMapSlot* slots = (IntMapSlot*) malloc( capacity * sizeof( IntMapSlot ) );
+   if( slots )
+   {
+      STATS_ALLOC( capacity * sizeof( IntMapSlot ) );
+      for( size_t i = 0; i < capacity; ++i ) slots[ i ].value = -1;
+   }
+   return slots;
+}
+
+static bool grow( IntMap* map )
+{
+   size_t old_capacity = map->capacity;
+   IntMapSlot* old = map->slots;
+
+   IntMapSlot* slots = new_slots( old_capacity * 2 );
+   if( !slots ) return false;
+
+   map->slots = slots;
+   map->capacity = old_capacity * 2;
+   ++map->bits;
+
+   for( size_t i = 0; i < old_capacity; ++i )
+   {
+      if( old[ i ].value != -1 )
+      {
+         size_t s = slot_of( map, old[ i ].key );
+         while( map->slots[ s ].value != -1 ) s = ( s + 1 ) & ( map->capacity - 1 );
+
+         map->slots[ s ] = old[ i ];
+      }
+   }
+
+   free( old );
+   return true;
+}
+
+
+IntMap* IntMap_New( size_t expected )
+{
+   IntMap* map = (IntMap*) malloc( sizeof( IntMap ) );
+   if( map )
+   {
+      map->bits = INTMAP_MIN_BITS;
+      while( ( (size_t) 1 << map->bits ) < 2 * expected ) ++map->bits;
+
+      map->capacity = (size_t) 1 << map->bits;
+
+      map->len = 0;
+      map->slots = new_slots( map->capacity );
+      if( !map->slots )
+      {
+         free( map );
+         map = NULL;
+      }
+   }
+
+   return map;
+}
+
+void IntMap_Delete( IntMap** p_map )
+{
+   assert( *p_map );
+
+   free( (*p_map)->slots );
+   free( *p_map );
+   *p_map = NULL;
+}
+
+bool IntMap_Insert( IntMap* map, int key, int value )
+{
+   assert( map );
+   assert( value >= 0 );
+
+   if( 2 * ( map->len + 1 ) > map->capacity && !grow( map ) ) return false;
+
+   size_t s = slot_of( map, key );
+   while( map->slots[ s ].value != -1 )
+   {
+      if( map->slots[ s ].key == key ) return false;
+
+      s = ( s + 1 ) & ( map->capacity - 1 );
+   }
+
+   map->slots[ s ].key = key;
+   map->slots[ s ].value = value;
+   ++map->len;
+   return true;
+}
+
+int IntMap_Find( const IntMap* map, int key )
+{
+   assert( map );
+
+   size_t s = slot_of( map, key );
+   while( map->slots[ s ].value != -1 )
+   {
+      if( map->slots[ s ].key == key ) return map->slots[ s ].value;
+
+      s = ( s + 1 ) & ( map->capacity - 1 );
+   }
+
+   return -1;
+}
+
+size_t IntMap_Len( const IntMap* map )
+{
+   return map->len;
+}
@@ -0,0 +1,60 @@
+#ifndef  INTMAP_INC
+#define  INTMAP_INC
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+/**
+ * @brief Una casilla de la tabla. |value| == -1 indica que la casilla está libre.
+ */
+typedef struct
+{
+   int key;
+   int value;
+} IntMapSlot;
+
+/**
+ * @brief Tabla hash con direccionamiento abierto (prueba lineal) de llaves enteras a valores no
+ * negativos (por ejemplo, índices en un arreglo).
+ */
+typedef struct
+{
+   IntMapSlot* slots;
+   size_t capacity; ///< siempre es una potencia de 2
+   unsigned bits;   ///< log2( capacity )
+   size_t len;      ///< número de llaves en la tabla
+} IntMap;
+
+/**
+ * @brief Crea una tabla vacía.
+ *
+ * @param expected Número de llaves que se espera guardar. La tabla crece sola si se rebasa.
+ *
+ * @return Una nueva tabla, o NULL si se agotó la memoria.
+ */
+IntMap* IntMap_New( size_t expected );
+void IntMap_Delete( IntMap** p_map );
+
+/**
+ * @brief Asocia |value| con |key|, si es que |key| no estaba ya en la tabla.
+ *
+ * @param map   La tabla.
+ * @param key   La llave.
+ * @param value El valor; debe ser no negativo.
+ *
+ * @return true si la llave se insertó; false si ya existía (su valor no cambia) o si se agotó la
+ * memoria.
+ */
+bool IntMap_Insert( IntMap* map, int key, int value );
+
+/**
+ * @brief Busca el valor asociado con |key|.
+ *
+ * @return El valor, o -1 si la llave no está en la tabla.
+ */
+int IntMap_Find( const IntMap* map, int key );
+
+size_t IntMap_Len( const IntMap* map );
+
+#endif   /* ----- #ifndef INTMAP_INC  ----- */
@@ -1,9 +1,91 @@
 
 #include "List.h"
+#include "Stats.h"
 
-static Node* new_node( int index, float weight )
+#define NODEPOOL_DEFAULT_SLAB_LEN 4096
+#define NODEPOOL_MAX_RUN 64
+
+// aparta hasta |len| nodos contiguos de la arena y guarda en |taken| cuántos apartó: si al bloque
+// actual le quedan menos, aparta los que le quedan (así el sobrante de un bloque sigue sirviendo
+// como tramo contiguo en lugar de partirse en nodos sueltos)
+static Node* pool_take_run( NodePool* pool, size_t len, size_t* taken )
+{
+   if( pool->bump == pool->bump_end )
+   {
+      NodeSlab* slab = (NodeSlab*) malloc( sizeof( NodeSlab ) + pool->slab_len * sizeof( Node ) );
+      if( !slab ) return NULL;
+      STATS_ALLOC( sizeof( NodeSlab ) + pool->slab_len * sizeof( Node ) );
+
+      slab->next = pool->slabs;
+      pool->slabs = slab;
+
+      pool->bump = slab->nodes;
+      pool->bump_end = slab->nodes + pool->slab_len;
+   }
+
+   size_t left = (size_t) ( pool->bump_end - pool->bump );
+   if( len > left ) len = left;
+
+   Node* run = pool->bump;
+   pool->bump += len;
+   *taken = len;
+   return run;
+}
+
+static Node* alloc_node( List* list )
+{
+   if( !list->pool )
+   {
+      STATS_ALLOC( sizeof( Node ) );
+      return (Node*) malloc( sizeof( Node ) );
+   }
+
+   if( list->reserved == list->reserved_end )
+   {
+      NodePool* pool = list->pool;
+
+      if( pool->bump == pool->bump_end && pool->free_list )
+      {
+         Node* n = pool->free_list;
+         pool->free_list = n->next;
+         return n;
+      }
+      // los nodos liberados sólo se reutilizan cuando habría que pedir otro bloque: los tramos
+      // contiguos tienen prioridad
+
+      size_t run = list->run ? 2 * list->run : 1;
+      if( run > NODEPOOL_MAX_RUN ) run = NODEPOOL_MAX_RUN;
+      if( run > pool->slab_len ) run = pool->slab_len;
+
+      size_t taken = 0;
+      list->reserved = pool_take_run( pool, run, &taken );
+      if( !list->reserved )
+      {
+         list->reserved_end = NULL;
+         return NULL;
+      }
+      list->reserved_end = list->reserved + taken;
+      list->run = run;
+   }
+
+   return list->reserved++;
+}
+
+static void free_node( List* list, Node* n )
 {
-   Node* n = (Node*) malloc( sizeof( Node ) );
+   if( !list->pool )
+   {
+      free( n );
+      return;
+   }
+
+   n->next = list->pool->free_list;
+   list->pool->free_list = n;
+}
+
+static Node* new_node( List* list, int index, float weight )
+{
+   Node* n = alloc_node( list );
    if( n != NULL )
    {
       n->data.index = index;
@@ -17,12 +99,51 @@ static Node* new_node( int index, float weight )
 }
 
 
+NodePool* NodePool_New( size_t slab_len )
+{
+   NodePool* pool = (NodePool*) malloc( sizeof( NodePool ) );
+   if( pool )
+   {
+      pool->slabs = NULL;
+      pool->free_list = NULL;
+      pool->bump = pool->bump_end = NULL;
+      pool->slab_len = slab_len > 0 ? slab_len : NODEPOOL_DEFAULT_SLAB_LEN;
+   }
+
+   return pool;
+}
+
+void NodePool_Delete( NodePool** p_pool )
+{
+   assert( *p_pool );
+
+   NodeSlab* slab = (*p_pool)->slabs;
+   while( slab )
+   {
+      NodeSlab* next = slab->next;
+      free( slab );
+      slab = next;
+   }
+
+   free( *p_pool );
+   *p_pool = NULL;
+}
+
 List* List_New()
+{
+   return List_New_from_pool( NULL );
+}
+
+List* List_New_from_pool( NodePool* pool )
 {
    List* lst = (List*) malloc( sizeof(List) );
    if( lst )
    {
       lst->first = lst->last = lst->cursor = NULL;
+
+      lst->pool = pool;
+      lst->reserved = lst->reserved_end = NULL;
+      lst->run = 0;
    }
 
    return lst;
@@ -37,6 +158,22 @@ void List_Delete( List** p_list )
       List_Pop_back( *p_list );
    }
 
+   // los nodos apartados que no se usaron regresan a la arena
+   List* list = *p_list;
+   while( list->reserved != list->reserved_end )
+   {
+      free_node( list, list->reserved++ );
+   }
+
+   free( *p_list );
+   *p_list = NULL;
+}
+
+void List_Release( List** p_list )
+{
+   assert( *p_list );
+   assert( (*p_list)->pool );
+
    free( *p_list );
    *p_list = NULL;
 }
@@ -45,7 +182,7 @@ void List_Push_back( List* list, int data, float weight )
 {
    assert( list );
    
-   Node* n = new_node( data, weight );
+   Node* n = new_node( list, data, weight );
    assert( n );
 
    if( list->first != NULL )
@@ -69,13 +206,13 @@ void List_Pop_back( List* list )
    if( list->last != list->first )
    {
       Node* x = list->last->prev;
-      free( list->last );
+      free_node( list, list->last );
       x->next = NULL;
       list->last = x;
    }
    else
    {
-      free( list->last );
+      free_node( list, list->last );
       list->first = list->last = list->cursor = NULL;
    }
 
@@ -177,7 +314,23 @@ Data  List_Cursor_get( List* list )
  * @post El cursor queda apuntando al elemento a la derecha del elemento eliminado; si
  * este hubiese sido el último, entonces el cursor apunta al primer elemento de la lista.
  */
-void List_Cursor_erase( List* list );
+void List_Cursor_erase( List* list )
+{
+   assert( list );
+   assert( list->cursor );
+
+   Node* n = list->cursor;
+
+   if( n->prev ) n->prev->next = n->next;
+   else          list->first = n->next;
+
+   if( n->next ) n->next->prev = n->prev;
+   else          list->last = n->prev;
+
+   list->cursor = n->next ? n->next : list->first;
+
+   free_node( list, n );
+}
 
 
 /**
@@ -23,16 +23,81 @@ typedef struct Node
    struct Node* prev;
 } Node;
 
+/**
+ * @brief Bloque de nodos contiguos pedido de una sola vez al sistema.
+ */
+typedef struct NodeSlab
+{
+   struct NodeSlab* next;
+   Node nodes[];
+} NodeSlab;
+
+/**
+ * @brief Arena de nodos que pueden compartir varias listas.
+ *
+ * Los nodos se piden en bloques (slabs) y los nodos liberados se reciclan por medio de una lista
+ * de libres, así que no hay una llamada a malloc()/free() por nodo. Los nodos liberados sólo se
+ * reutilizan cuando el bloque actual se agotó, para no romper los tramos contiguos de las listas
+ * mientras quede lugar en él. Al destruir la arena se liberan
+ * todos sus nodos en O(número de bloques).
+ */
+typedef struct
+{
+   NodeSlab* slabs;   ///< bloques pedidos hasta ahora
+   Node* free_list;   ///< nodos liberados, encadenados por |next|
+   Node* bump;        ///< primer nodo sin usar del bloque actual
+   Node* bump_end;    ///< fin del bloque actual
+   size_t slab_len;   ///< número de nodos por bloque
+} NodePool;
+
 typedef struct
 {
    Node* first;
    Node* last;
    Node* cursor;
+
+   NodePool* pool;    ///< de dónde salen los nodos; NULL para usar malloc()
+   Node* reserved;    ///< siguiente nodo libre del tramo apartado para esta lista
+   Node* reserved_end;
+   size_t run;        ///< tamaño del último tramo apartado
 } List;
 
+/**
+ * @brief Crea una arena de nodos.
+ *
+ * @param slab_len Número de nodos por bloque; 0 para usar el valor por omisión.
+ *
+ * @return Una nueva arena, o NULL si se agotó la memoria.
+ */
+NodePool* NodePool_New( size_t slab_len );
+
+/**
+ * @brief Destruye la arena y todos sus nodos.
+ *
+ * @pre Ninguna lista viva usa a la arena (ver List_Release()).
+ */
+void NodePool_Delete( NodePool** p_pool );
+
 List* List_New();
+
+/**
+ * @brief Crea una lista cuyos nodos salen de la arena |pool|.
+ *
+ * La lista aparta tramos contiguos de nodos de tamaño creciente, de manera que sus nodos quedan
+ * juntos en memoria aunque se inserte en varias listas de manera intercalada.
+ */
+List* List_New_from_pool( NodePool* pool );
+
 void List_Delete( List** p_list );
 
+/**
+ * @brief Destruye la lista sin devolver sus nodos uno por uno.
+ *
+ * Sólo es válida para listas creadas con List_New_from_pool(); los nodos se liberan al destruir la
+ * arena con NodePool_Delete().
+ */
+void List_Release( List** p_list );
+
 void List_Push_back( List* list, int index, float weight );
 void List_Pop_back( List* list );
 
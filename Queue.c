@@ -1,9 +1,44 @@
 
 #include "Queue.h"
+#include "Stats.h"
+
+#include <string.h>
+
+// la capacidad más pequeña que sea potencia de 2 y no menor que |size|
+static int round_up_pow2( int size )
+{
+   int capacity = 1;
+   while( capacity < size ) capacity *= 2;
+   return capacity;
+}
+
+// duplica la capacidad hasta que quepan |needed| elementos; los elementos quedan desenrollados
+// a partir de la posición 0
+static void grow( Queue* this, size_t needed )
+{
+   int size = this->size;
+   while( (size_t) size < needed ) size *= 2;
+
+   int* q = (int*) malloc( size * sizeof( int ) );
+   assert( q );
+   STATS_ALLOC( size * sizeof( int ) );
+
+   size_t n = Queue_DequeueN( this, q, this->len );
+
+   free( this->q );
+   this->q = q;
+   this->size = size;
+   this->front = 0;
+   this->back = n & ( size - 1 );
+   this->len = n;
+}
 
 
 /**
  * @brief Crea una cola nueva.
+ *
+ * @param size Capacidad inicial. Se redondea hacia arriba a una potencia de 2 y se duplica cada
+ * vez que la cola se llena.
  */
 Queue* Queue_New( int size )
 {
@@ -11,13 +46,15 @@ Queue* Queue_New( int size )
 	
 	if( q ){
       q->front = q->back = q->len = 0;
-      q->size = size;
+      q->size = round_up_pow2( size );
 
-      q->q = (int*) malloc( size * sizeof( int ) );
+      q->q = (int*) malloc( q->size * sizeof( int ) );
       if( ! q->q )
       {
          free( q );
+         q = NULL;
       }
+      else STATS_ALLOC( q->size * sizeof( int ) );
 	}
 
 	return q;
@@ -43,17 +80,42 @@ void Queue_Delete( Queue** this )
  * @param this Referencia a un objeto Queue.
  * @param value El valor a insertar.
  *
- * @return false si se agotó la memoria y el valor no se pudo insertar. true en
- * caso contrario.
+ * Si la cola está llena su capacidad se duplica.
  */
 void Queue_Enqueue( Queue* this, int value )
 {
-   assert( this->len < this->size );
+   if( this->len == this->size ) grow( this, this->len + 1 );
 
    this->q[ this->back ] = value;
    ++this->len;
    ++this->back;
-   this->back = this->back % this->size;
+   this->back = this->back & ( this->size - 1 );
+
+   STATS_MAX( queue_high_water, this->len );
+}
+
+/**
+ * @brief Inserta varios elementos en la cola, en orden.
+ *
+ * @param this Referencia a un objeto Queue.
+ * @param values Los valores a insertar.
+ * @param n El número de valores.
+ */
+void Queue_EnqueueN( Queue* this, const int* values, size_t n )
+{
+   if( this->len + n > (size_t) this->size ) grow( this, this->len + n );
+
+   // a lo más dos tramos: hasta el final del arreglo y luego desde el principio
+   size_t first = this->size - this->back;
+   if( first > n ) first = n;
+
+   memcpy( this->q + this->back, values, first * sizeof( int ) );
+   memcpy( this->q, values + first, ( n - first ) * sizeof( int ) );
+
+   this->len += n;
+   this->back = ( this->back + n ) & ( this->size - 1 );
+
+   STATS_MAX( queue_high_water, this->len );
 }
 
 /**
@@ -72,10 +134,34 @@ int Queue_Dequeue( Queue* this )
 
    --this->len;
    ++this->front;
-   this->front = this->front % this->size;
+   this->front = this->front & ( this->size - 1 );
    return tmp;
 }
 
+/**
+ * @brief Extrae varios elementos de la cola.
+ *
+ * @param this Referencia a un objeto Queue.
+ * @param values Receptáculo para los valores extraídos, en orden.
+ * @param n El número máximo de valores a extraer.
+ *
+ * @return El número de valores extraídos: el menor entre |n| y el número de elementos en la cola.
+ */
+size_t Queue_DequeueN( Queue* this, int* values, size_t n )
+{
+   if( n > (size_t) this->len ) n = this->len;
+
+   size_t first = this->size - this->front;
+   if( first > n ) first = n;
+
+   memcpy( values, this->q + this->front, first * sizeof( int ) );
+   memcpy( values + first, this->q, ( n - first ) * sizeof( int ) );
+
+   this->len -= n;
+   this->front = ( this->front + n ) & ( this->size - 1 );
+   return n;
+}
+
 
 /**
  * @brief 'Observa' al valor en el frente de la cola.
@@ -104,6 +190,18 @@ bool Queue_IsEmpty( Queue* this )
 	return this->len == 0;
 }
 
+/**
+ * @brief Indica si la cola ocupa toda su capacidad actual.
+ *
+ * @param this Referencia a un objeto Queue.
+ *
+ * @return true si la siguiente inserción hará crecer a la cola. false en caso contrario.
+ */
+bool Queue_IsFull( Queue* this )
+{
+	return this->len == this->size;
+}
+
 /**
  * @brief Indica el número de elementos actuales en la cola.
  *
@@ -42,13 +42,15 @@ typedef struct
    int front;
    int back;
    int len;
-   int size;
+   int size;   ///< capacidad actual; siempre es una potencia de 2
 } Queue;
 
-Queue* Queue_New();
+Queue* Queue_New(       int size );
 void   Queue_Delete(    Queue* *this );
 void   Queue_Enqueue(   Queue* this, int value );
+void   Queue_EnqueueN(  Queue* this, const int* values, size_t n );
 int    Queue_Dequeue(   Queue* this );
+size_t Queue_DequeueN(  Queue* this, int* values, size_t n );
 int    Queue_Peek(      Queue* this );
 bool   Queue_IsEmpty(   Queue* this );
 bool   Queue_IsFull(    Queue* this );
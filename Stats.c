@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 200809L
+// clock_gettime()
+
+#include "Stats.h"
+
+#include <stdbool.h>
+#include <time.h>
+
+GraphStats graph_stats;
+
+static const char* phase_names[ eStatsPhase_COUNT ] =
+{
+   "build", "load", "freeze", "dfs", "bfs", "toposort",
+};
+
+uint64_t Stats_Now( void )
+{
+   struct timespec ts;
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+void Stats_Max( uint64_t* field, uint64_t value )
+{
+   uint64_t current = __atomic_load_n( field, __ATOMIC_RELAXED );
+
+   while( current < value &&
+          !__atomic_compare_exchange_n( field, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+   {
+      ;
+      // |current| se actualizó con el valor que otro hilo acaba de escribir
+   }
+}
+
+void Stats_PhaseEnd( eStatsPhase phase, uint64_t start )
+{
+   __atomic_fetch_add( &graph_stats.phase_ns[ phase ], Stats_Now() - start, __ATOMIC_RELAXED );
+   __atomic_fetch_add( &graph_stats.phase_calls[ phase ], 1, __ATOMIC_RELAXED );
+}
+
+GraphStats Graph_Stats( void )
+{
+   GraphStats s;
+
+   uint64_t* dst = (uint64_t*) &s;
+   uint64_t* src = (uint64_t*) &graph_stats;
+   for( size_t i = 0; i < sizeof( GraphStats ) / sizeof( uint64_t ); ++i )
+   {
+      dst[ i ] = __atomic_load_n( &src[ i ], __ATOMIC_RELAXED );
+   }
+   // GraphStats sólo tiene campos uint64_t
+
+   return s;
+}
+
+void Graph_StatsReset( void )
+{
+   uint64_t* src = (uint64_t*) &graph_stats;
+   for( size_t i = 0; i < sizeof( GraphStats ) / sizeof( uint64_t ); ++i )
+   {
+      __atomic_store_n( &src[ i ], 0, __ATOMIC_RELAXED );
+   }
+}
+
+void Graph_StatsPrintJson( FILE* out )
+{
+   GraphStats s = Graph_Stats();
+
+   fprintf( out, "{\n" );
+   fprintf( out, "  \"enabled\": %s,\n", GRAPH_STATS > 0 ? "true" : "false" );
+   fprintf( out, "  \"vertices_visited\": %llu,\n", (unsigned long long) s.vertices_visited );
+   fprintf( out, "  \"edges_scanned\": %llu,\n", (unsigned long long) s.edges_scanned );
+   fprintf( out, "  \"key_lookups\": %llu,\n", (unsigned long long) s.key_lookups );
+   fprintf( out, "  \"duplicate_edges\": %llu,\n", (unsigned long long) s.duplicate_edges );
+   fprintf( out, "  \"allocations\": %llu,\n", (unsigned long long) s.allocations );
+   fprintf( out, "  \"bytes_allocated\": %llu,\n", (unsigned long long) s.bytes_allocated );
+   fprintf( out, "  \"queue_high_water\": %llu,\n", (unsigned long long) s.queue_high_water );
+   fprintf( out, "  \"stack_high_water\": %llu,\n", (unsigned long long) s.stack_high_water );
+
+   fprintf( out, "  \"phases\": {\n" );
+   for( int p = 0; p < eStatsPhase_COUNT; ++p )
+   {
+      fprintf( out, "    \"%s\": { \"calls\": %llu, \"ns\": %llu }%s\n",
+            phase_names[ p ],
+            (unsigned long long) s.phase_calls[ p ],
+            (unsigned long long) s.phase_ns[ p ],
+            p + 1 < eStatsPhase_COUNT ? "," : "" );
+   }
+   fprintf( out, "  }\n" );
+   fprintf( out, "}\n" );
+}
@@ -0,0 +1,95 @@
+#ifndef  STATS_INC
+#define  STATS_INC
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Contadores de desempeño para la construcción y los recorridos de los grafos.
+ *
+ * Se activan al compilar con -DGRAPH_STATS=1. Por omisión cada STATS_*() se reduce a una sentencia
+ * vacía y Graph_Stats() devuelve puros ceros. Los contadores son globales y se actualizan con
+ * sumas atómicas relajadas, así que se pueden usar desde varios hilos.
+ */
+
+#ifndef GRAPH_STATS
+#define GRAPH_STATS 0
+#endif
+
+/** Fases cuyo tiempo se mide.
+ */
+typedef enum
+{
+   eStatsPhase_BUILD,    ///< Graph_AddEdge(), Graph_AddEdges()
+   eStatsPhase_LOAD,     ///< Graph_LoadEdgeList()
+   eStatsPhase_FREEZE,   ///< Graph_Freeze()
+   eStatsPhase_DFS,      ///< búsquedas en profundidad (Graph_Dfs(), dfs_topol_traverse())
+   eStatsPhase_BFS,      ///< Graph_Bfs()
+   eStatsPhase_TOPOSORT, ///< ordenamientos topológicos
+   eStatsPhase_COUNT
+} eStatsPhase;
+
+/**
+ * @brief Los contadores.
+ */
+typedef struct
+{
+   uint64_t vertices_visited; ///< vértices descubiertos por los recorridos
+   uint64_t edges_scanned;    ///< aristas revisadas por los recorridos
+   uint64_t key_lookups;      ///< búsquedas de un vértice por su llave
+   uint64_t duplicate_edges;  ///< aristas rechazadas por estar repetidas
+   uint64_t allocations;      ///< bloques pedidos (o agrandados) con malloc()/realloc()
+   uint64_t bytes_allocated;  ///< bytes de esos bloques
+   uint64_t queue_high_water; ///< mayor número de elementos en una Queue
+   uint64_t stack_high_water; ///< mayor profundidad de la pila de la búsqueda en profundidad
+
+   uint64_t phase_ns[ eStatsPhase_COUNT ];    ///< tiempo de reloj acumulado, en nanosegundos
+   uint64_t phase_calls[ eStatsPhase_COUNT ]; ///< veces que se entró a cada fase
+} GraphStats;
+
+#if GRAPH_STATS > 0
+
+extern GraphStats graph_stats;
+
+#define STATS_ADD( field, n ) __atomic_fetch_add( &graph_stats.field, (uint64_t) ( n ), __ATOMIC_RELAXED )
+#define STATS_MAX( field, v ) Stats_Max( &graph_stats.field, (uint64_t) ( v ) )
+#define STATS_ALLOC( bytes ) do{ STATS_ADD( allocations, 1 ); STATS_ADD( bytes_allocated, bytes ); } while( 0 )
+
+// STATS_PHASE_BEGIN( t ) declara la variable |t| con la hora de inicio
+#define STATS_PHASE_BEGIN( t ) uint64_t t = Stats_Now()
+#define STATS_PHASE_END( phase, t ) Stats_PhaseEnd( phase, t )
+
+#else
+
+#define STATS_ADD( field, n ) do{ } while( 0 )
+#define STATS_MAX( field, v ) do{ } while( 0 )
+#define STATS_ALLOC( bytes ) do{ } while( 0 )
+#define STATS_PHASE_BEGIN( t ) do{ } while( 0 )
+#define STATS_PHASE_END( phase, t ) do{ } while( 0 )
+
+#endif
+
+// funciones de apoyo de las macros
+uint64_t Stats_Now( void );
+void Stats_Max( uint64_t* field, uint64_t value );
+void Stats_PhaseEnd( eStatsPhase phase, uint64_t start );
+
+/**
+ * @brief Devuelve una copia de los contadores.
+ */
+GraphStats Graph_Stats( void );
+
+/**
+ * @brief Pone todos los contadores en 0.
+ */
+void Graph_StatsReset( void );
+
+/**
+ * @brief Imprime los contadores como un objeto JSON.
+ *
+ * @param out Dónde imprimir (por ejemplo, stdout).
+ */
+void Graph_StatsPrintJson( FILE* out );
+
+#endif   /* ----- #ifndef STATS_INC  ----- */
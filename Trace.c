@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200809L
+// flockfile()
+
+#include "Trace.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+// valor de |seq| mientras alguien escribe o lee la casilla
+#define SLOT_BUSY UINT64_MAX
+
+/**
+ * @brief Una casilla del búfer circular.
+ *
+ * |seq| vale número de mensaje + 1 cuando la casilla está completa (0 si nunca se ha usado), y
+ * SLOT_BUSY mientras un hilo la tiene apartada. Quien no logra apartarla no espera: un escritor
+ * descarta su mensaje y Trace_DumpRing() se salta la casilla.
+ */
+typedef struct
+{
+   uint64_t seq;
+   int level;
+   char msg[ TRACE_MSG_LEN ];
+} TraceSlot;
+
+static TraceSlot* ring = NULL;
+static size_t ring_mask = 0;
+static uint64_t ring_head = 0; ///< número de mensajes que se han escrito (atómico)
+static uint64_t ring_tail = 0; ///< primer mensaje que no se ha impreso
+static uint64_t ring_dropped = 0; ///< mensajes descartados (atómico)
+
+static const char* level_name( int level )
+{
+   switch( level )
+   {
+      case TRACE_ERROR: return "error";
+      case TRACE_WARN:  return "warn";
+      case TRACE_INFO:  return "info";
+      default:          return "debug";
+   }
+}
+
+void Trace_Emit( int level, const char* fmt, ... )
+{
+   va_list args;
+   va_start( args, fmt );
+
+   if( ring )
+   {
+      uint64_t n = __atomic_fetch_add( &ring_head, 1, __ATOMIC_RELAXED );
+      TraceSlot* slot = &ring[ n & ring_mask ];
+
+      uint64_t seq = __atomic_load_n( &slot->seq, __ATOMIC_RELAXED );
+
+      // sólo se aparta la casilla si está libre y guarda un mensaje más viejo que éste (un hilo que
+      // ya dio la vuelta al búfer pudo haberla escrito primero)
+      if( seq != SLOT_BUSY && seq < n + 1 &&
+          __atomic_compare_exchange_n( &slot->seq, &seq, SLOT_BUSY, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) )
+      {
+         slot->level = level;
+         vsnprintf( slot->msg, TRACE_MSG_LEN, fmt, args );
+
+         __atomic_store_n( &slot->seq, n + 1, __ATOMIC_RELEASE );
+      }
+      else __atomic_fetch_add( &ring_dropped, 1, __ATOMIC_RELAXED );
+   }
+   else
+   {
+      flockfile( stderr );
+      // para que los mensajes de distintos hilos no se mezclen
+      fprintf( stderr, "[%s] ", level_name( level ) );
+      vfprintf( stderr, fmt, args );
+      funlockfile( stderr );
+   }
+
+   va_end( args );
+}
+
+bool Trace_OpenRing( size_t capacity )
+{
+   size_t len = 1;
+   while( len < capacity ) len *= 2;
+
+   TraceSlot* slots = (TraceSlot*) calloc( len, sizeof( TraceSlot ) );
+   if( !slots ) return false;
+
+   Trace_CloseRing();
+
+   ring_mask = len - 1;
+   ring_head = ring_tail = ring_dropped = 0;
+   ring = slots;
+   return true;
+}
+
+void Trace_CloseRing( void )
+{
+   free( ring );
+   ring = NULL;
+   ring_mask = 0;
+}
+
+void Trace_DumpRing( FILE* out )
+{
+   if( !ring ) return;
+
+   uint64_t head = __atomic_load_n( &ring_head, __ATOMIC_ACQUIRE );
+
+   uint64_t first = ring_tail;
+   if( head - first > ring_mask + 1 ) first = head - ( ring_mask + 1 );
+   // los más viejos ya se reemplazaron
+
+   for( uint64_t n = first; n < head; ++n )
+   {
+      TraceSlot* slot = &ring[ n & ring_mask ];
+
+      uint64_t seq = n + 1;
+      if( !__atomic_compare_exchange_n( &slot->seq, &seq, SLOT_BUSY, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) continue;
+      // la casilla ya se reemplazó, o alguien la está escribiendo
+
+      int level = slot->level;
+      char msg[ TRACE_MSG_LEN ];
+      memcpy( msg, slot->msg, TRACE_MSG_LEN );
+
+      __atomic_store_n( &slot->seq, n + 1, __ATOMIC_RELEASE );
+
+      msg[ TRACE_MSG_LEN - 1 ] = '\0';
+      size_t len = strlen( msg );
+      fprintf( out, "[%s] %s%s", level_name( level ), msg, len > 0 && msg[ len - 1 ] == '\n' ? "" : "\n" );
+      // un mensaje truncado pierde su salto de línea
+   }
+
+   ring_tail = head;
+
+   uint64_t dropped = __atomic_exchange_n( &ring_dropped, 0, __ATOMIC_RELAXED );
+   if( dropped > 0 ) fprintf( out, "[trace] %llu mensajes descartados\n", (unsigned long long) dropped );
+}
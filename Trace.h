@@ -0,0 +1,103 @@
+#ifndef  TRACE_INC
+#define  TRACE_INC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Mensajes de depuración por niveles, filtrados al compilar.
+ *
+ * Se compila con -DTRACE_LEVEL=n para conservar los mensajes de nivel n o menor; por omisión
+ * TRACE_LEVEL es TRACE_OFF y cada TRACE_*() se reduce a una sentencia vacía: no se evalúan sus
+ * argumentos ni queda ninguna llamada en el ejecutable.
+ *
+ * Los mensajes van a stderr, o a un búfer circular en memoria (ver Trace_OpenRing()) que se vacía
+ * con Trace_DumpRing() cuando se necesite.
+ */
+
+#define TRACE_OFF   0
+#define TRACE_ERROR 1
+#define TRACE_WARN  2
+#define TRACE_INFO  3
+#define TRACE_DEBUG 4 ///< un mensaje por arista o por vértice visitado
+
+// compatibilidad: -DDBG_HELP=1 equivale a -DTRACE_LEVEL=TRACE_DEBUG
+#ifndef TRACE_LEVEL
+#if defined( DBG_HELP ) && DBG_HELP > 0
+#define TRACE_LEVEL TRACE_DEBUG
+#else
+#define TRACE_LEVEL TRACE_OFF
+#endif
+#endif
+
+#if TRACE_LEVEL >= TRACE_ERROR
+#define TRACE_E( ... ) Trace_Emit( TRACE_ERROR, __VA_ARGS__ )
+#else
+#define TRACE_E( ... ) do{ } while( 0 )
+#endif
+
+#if TRACE_LEVEL >= TRACE_WARN
+#define TRACE_W( ... ) Trace_Emit( TRACE_WARN, __VA_ARGS__ )
+#else
+#define TRACE_W( ... ) do{ } while( 0 )
+#endif
+
+#if TRACE_LEVEL >= TRACE_INFO
+#define TRACE_I( ... ) Trace_Emit( TRACE_INFO, __VA_ARGS__ )
+#else
+#define TRACE_I( ... ) do{ } while( 0 )
+#endif
+
+#if TRACE_LEVEL >= TRACE_DEBUG
+#define TRACE_D( ... ) Trace_Emit( TRACE_DEBUG, __VA_ARGS__ )
+#else
+#define TRACE_D( ... ) do{ } while( 0 )
+#endif
+
+// longitud máxima de un mensaje guardado en el búfer circular (los más largos se truncan)
+#define TRACE_MSG_LEN 120
+
+/**
+ * @brief Escribe un mensaje con formato de printf(). No se llama directamente: se usan las macros
+ * TRACE_E(), TRACE_W(), TRACE_I() y TRACE_D().
+ *
+ * Se puede llamar desde varios hilos a la vez.
+ */
+void Trace_Emit( int level, const char* fmt, ... );
+
+/**
+ * @brief Manda los mensajes siguientes a un búfer circular en memoria en lugar de a stderr.
+ *
+ * Escribir en el búfer no usa candados: cada mensaje reserva su casilla con una suma atómica.
+ * Cuando el búfer se llena, los mensajes nuevos reemplazan a los más viejos; si la casilla está
+ * ocupada por otro hilo en ese momento, el mensaje se descarta (y se cuenta).
+ *
+ * @param capacity Número de mensajes que caben; se redondea a una potencia de 2.
+ *
+ * @return false si se agotó la memoria (los mensajes siguen yendo a stderr).
+ *
+ * @pre Ningún otro hilo está escribiendo mensajes.
+ */
+bool Trace_OpenRing( size_t capacity );
+
+/**
+ * @brief Libera el búfer circular; los mensajes siguientes van a stderr.
+ *
+ * @pre Ningún otro hilo está escribiendo mensajes.
+ */
+void Trace_CloseRing( void );
+
+/**
+ * @brief Imprime los mensajes del búfer circular, del más viejo al más nuevo, y lo vacía.
+ *
+ * Si otros hilos siguen escribiendo, se omiten las casillas que se estén reemplazando en ese
+ * momento. Al final se indica cuántos mensajes se descartaron.
+ *
+ * @param out Dónde imprimir (por ejemplo, stderr).
+ */
+void Trace_DumpRing( FILE* out );
+
+#endif   /* ----- #ifndef TRACE_INC  ----- */
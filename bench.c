@@ -0,0 +1,365 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "Graph.h"
+#include "Stats.h"
+
+/**
+ * @file
+ * @brief Mide la construcción, los recorridos y la destrucción de grafos sintéticos.
+ *
+ * Uso: bench.out [-n vértices] [-r repeticiones] [-g generador]
+ *
+ * Generadores: chain, dag, rmat, grid, clique o all (por omisión). Cada fase se repite |r| veces y
+ * se reportan la mediana y el percentil 99 en milisegundos.
+ */
+
+#define BENCH_DEFAULT_N    100000
+#define BENCH_DEFAULT_REPS 11
+#define BENCH_DAG_DEGREE   8      ///< aristas por vértice en dag y rmat
+
+
+//----------------------------------------------------------------------
+//                           Generadores
+//----------------------------------------------------------------------
+
+/**
+ * @brief Las aristas de un grafo sintético; los vértices son las llaves 0 ... len - 1.
+ */
+typedef struct
+{
+   const char* name;
+   int len;        ///< número de vértices
+   int* src;
+   int* dst;
+   size_t edges;
+   size_t capacity;
+} EdgeList;
+
+static void EdgeList_Push( EdgeList* list, int src, int dst )
+{
+   if( list->edges == list->capacity )
+   {
+      list->capacity = list->capacity ? 2 * list->capacity : 1024;
+      list->src = (int*) realloc( list->src, list->capacity * sizeof( int ) );
+      list->dst = (int*) realloc( list->dst, list->capacity * sizeof( int ) );
+      assert( list->src && list->dst );
+   }
+
+   list->src[ list->edges ] = src;
+   list->dst[ list->edges ] = dst;
+   ++list->edges;
+}
+
+static void EdgeList_Destroy( EdgeList* list )
+{
+   free( list->src );
+   free( list->dst );
+   list->src = list->dst = NULL;
+   list->edges = list->capacity = 0;
+}
+
+// xorshift64*: rápido y con semilla fija, para que todas las corridas usen el mismo grafo
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t rng_next( void )
+{
+   rng_state ^= rng_state >> 12;
+   rng_state ^= rng_state << 25;
+   rng_state ^= rng_state >> 27;
+   return rng_state * 2685821657736338717ull;
+}
+
+static int rng_below( int n )
+{
+   return (int) ( rng_next() % (uint64_t) n );
+}
+
+static double rng_unit( void )
+{
+   return ( rng_next() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+// una cadena 0 -> 1 -> ... -> n - 1: la búsqueda en profundidad llega a profundidad n
+static void gen_chain( EdgeList* list, int n )
+{
+   list->len = n;
+   for( int v = 0; v + 1 < n; ++v ) EdgeList_Push( list, v, v + 1 );
+}
+
+// un DAG aleatorio: cada arista va de un vértice menor a uno mayor
+static void gen_dag( EdgeList* list, int n )
+{
+   list->len = n;
+   if( n < 2 ) return;
+
+   for( size_t e = 0; e < (size_t) n * BENCH_DAG_DEGREE; ++e )
+   {
+      int u = rng_below( n );
+      int v = rng_below( n );
+      if( u == v ) continue;
+
+      EdgeList_Push( list, u < v ? u : v, u < v ? v : u );
+   }
+}
+
+// R-MAT (a, b, c, d) = (0.57, 0.19, 0.19, 0.05): grados con ley de potencia, con ciclos
+static void gen_rmat( EdgeList* list, int n )
+{
+   int scale = 0;
+   while( ( 1 << scale ) < n ) ++scale;
+
+   list->len = 1 << scale;
+
+   for( size_t e = 0; e < (size_t) list->len * BENCH_DAG_DEGREE; ++e )
+   {
+      int u = 0, v = 0;
+
+      for( int bit = 0; bit < scale; ++bit )
+      {
+         double r = rng_unit();
+
+         if( r < 0.57 ) { }
+         else if( r < 0.76 ) v |= 1 << bit;
+         else if( r < 0.95 ) u |= 1 << bit;
+         else { u |= 1 << bit; v |= 1 << bit; }
+      }
+
+      EdgeList_Push( list, u, v );
+   }
+}
+
+// una rejilla de side x side con aristas hacia la derecha y hacia abajo (es un DAG)
+static void gen_grid( EdgeList* list, int n )
+{
+   int side = 1;
+   while( ( side + 1 ) * ( side + 1 ) <= n ) ++side;
+
+   list->len = side * side;
+
+   for( int r = 0; r < side; ++r )
+   {
+      for( int c = 0; c < side; ++c )
+      {
+         int v = r * side + c;
+         if( c + 1 < side ) EdgeList_Push( list, v, v + 1 );
+         if( r + 1 < side ) EdgeList_Push( list, v, v + side );
+      }
+   }
+}
+
+// un torneo transitivo (i -> j para todo i < j) de k vértices, con k tal que haya del orden de
+// 4n aristas
+static void gen_clique( EdgeList* list, int n )
+{
+   int k = 2;
+   while( (size_t) ( k + 1 ) * k / 2 <= (size_t) n * 4 ) ++k;
+
+   list->len = k;
+
+   for( int i = 0; i < k; ++i )
+   {
+      for( int j = i + 1; j < k; ++j ) EdgeList_Push( list, i, j );
+   }
+}
+
+static const struct
+{
+   const char* name;
+   void (*fn)( EdgeList*, int );
+} generators[] =
+{
+   { "chain",  gen_chain },
+   { "dag",    gen_dag },
+   { "rmat",   gen_rmat },
+   { "grid",   gen_grid },
+   { "clique", gen_clique },
+};
+
+#define NUM_GENERATORS ( sizeof( generators ) / sizeof( generators[ 0 ] ) )
+
+
+//----------------------------------------------------------------------
+//                           Mediciones
+//----------------------------------------------------------------------
+
+typedef enum
+{
+   ePhase_BUILD_EDGE,  ///< Graph_New() + Graph_AddVertex() + Graph_AddEdge() por arista
+   ePhase_BUILD_BULK,  ///< Graph_New() + Graph_AddVertex() + un solo Graph_AddEdges()
+   ePhase_DFS,
+   ePhase_TOPOSORT,
+   ePhase_BFS,
+   ePhase_REVERSE,     ///< Graph_SetReverse( g, true ): construir los vecinos de entrada
+   ePhase_BFS_DIROPT,  ///< Graph_BfsDirectionOptimizing(), con los vecinos de entrada ya construidos
+   ePhase_TEARDOWN,    ///< Graph_Delete(), sin vecinos de entrada (como antes de bfs_diropt)
+   ePhase_COUNT
+} ePhase;
+
+static const char* phase_names[ ePhase_COUNT ] =
+{
+   "build_edge", "build_bulk", "dfs", "toposort", "bfs", "reverse", "bfs_diropt", "teardown",
+};
+
+static int cmp_u64( const void* a, const void* b )
+{
+   uint64_t x = *(const uint64_t*) a;
+   uint64_t y = *(const uint64_t*) b;
+   return x < y ? -1 : ( x > y );
+}
+
+// percentil |p| (0 ... 100) por rango más cercano; |samples| debe estar ordenado
+static uint64_t percentile( const uint64_t* samples, int n, int p )
+{
+   int rank = ( p * n + 99 ) / 100;
+   if( rank < 1 ) rank = 1;
+   return samples[ rank - 1 ];
+}
+
+static Graph* build_graph( const EdgeList* list )
+{
+   Graph* g = Graph_New( list->len, eGraphType_DIRECTED );
+   assert( g );
+
+   for( int v = 0; v < list->len; ++v ) Graph_AddVertex( g, v );
+
+   return g;
+}
+
+static void run( const EdgeList* list, int reps )
+{
+   uint64_t* samples[ ePhase_COUNT ];
+   for( int p = 0; p < ePhase_COUNT; ++p )
+   {
+      samples[ p ] = (uint64_t*) malloc( reps * sizeof( uint64_t ) );
+      assert( samples[ p ] );
+   }
+
+   int* order = (int*) malloc( list->len * sizeof( int ) );
+   TraversalContext* ctx = TraversalContext_New();
+   assert( order && ctx );
+
+   int reached_dfs = 0, reached_bfs = 0;
+   eTopoSortResult topo = eTopoSort_OK;
+
+   for( int r = 0; r < reps; ++r )
+   {
+      uint64_t t0 = Stats_Now();
+      Graph* g = build_graph( list );
+      for( size_t e = 0; e < list->edges; ++e ) Graph_AddEdge( g, list->src[ e ], list->dst[ e ] );
+      uint64_t t1 = Stats_Now();
+      Graph_Delete( &g );
+      samples[ ePhase_BUILD_EDGE ][ r ] = t1 - t0;
+
+      t0 = Stats_Now();
+      g = build_graph( list );
+      bool ok = Graph_AddEdges( g, list->src, list->dst, NULL, list->edges );
+      assert( ok );
+      (void) ok;
+      t1 = Stats_Now();
+      samples[ ePhase_BUILD_BULK ][ r ] = t1 - t0;
+
+      t0 = Stats_Now();
+      reached_dfs = Graph_Dfs( g, 0, ctx );
+      t1 = Stats_Now();
+      samples[ ePhase_DFS ][ r ] = t1 - t0;
+
+      t0 = Stats_Now();
+      topo = Graph_TopologicalSort( g, eTopoSort_KAHN, order, NULL, NULL );
+      t1 = Stats_Now();
+      samples[ ePhase_TOPOSORT ][ r ] = t1 - t0;
+
+      t0 = Stats_Now();
+      reached_bfs = Graph_Bfs( g, 0, ctx );
+      t1 = Stats_Now();
+      samples[ ePhase_BFS ][ r ] = t1 - t0;
+
+      t0 = Stats_Now();
+      ok = Graph_SetReverse( g, true );
+      t1 = Stats_Now();
+      samples[ ePhase_REVERSE ][ r ] = t1 - t0;
+      assert( ok );
+
+      t0 = Stats_Now();
+      int reached = Graph_BfsDirectionOptimizing( g, 0, ctx );
+      t1 = Stats_Now();
+      samples[ ePhase_BFS_DIROPT ][ r ] = t1 - t0;
+      assert( reached == reached_bfs );
+      (void) reached;
+
+      // fuera de la medición, para que teardown siga midiendo lo mismo que antes
+      Graph_SetReverse( g, false );
+
+      t0 = Stats_Now();
+      Graph_Delete( &g );
+      t1 = Stats_Now();
+      samples[ ePhase_TEARDOWN ][ r ] = t1 - t0;
+   }
+
+   printf( "%s: %d vertices, %zu edges, dfs reached %d, bfs reached %d, %s\n",
+         list->name, list->len, list->edges, reached_dfs, reached_bfs,
+         topo == eTopoSort_OK ? "acyclic" : "cyclic" );
+
+   for( int p = 0; p < ePhase_COUNT; ++p )
+   {
+      qsort( samples[ p ], reps, sizeof( uint64_t ), cmp_u64 );
+
+      printf( "   %-10s median %10.3f ms   p99 %10.3f ms\n",
+            phase_names[ p ],
+            percentile( samples[ p ], reps, 50 ) / 1e6,
+            percentile( samples[ p ], reps, 99 ) / 1e6 );
+
+      free( samples[ p ] );
+   }
+
+   TraversalContext_Delete( &ctx );
+   free( order );
+}
+
+static void usage( const char* prog )
+{
+   fprintf( stderr, "usage: %s [-n vertices] [-r repetitions] [-g chain|dag|rmat|grid|clique|all]\n", prog );
+   exit( EXIT_FAILURE );
+}
+
+int main( int argc, char* argv[] )
+{
+   int n = BENCH_DEFAULT_N;
+   int reps = BENCH_DEFAULT_REPS;
+   const char* which = "all";
+
+   for( int i = 1; i < argc; ++i )
+   {
+      if( i + 1 >= argc ) usage( argv[ 0 ] );
+
+      if( strcmp( argv[ i ], "-n" ) == 0 ) n = atoi( argv[ ++i ] );
+      else if( strcmp( argv[ i ], "-r" ) == 0 ) reps = atoi( argv[ ++i ] );
+      else if( strcmp( argv[ i ], "-g" ) == 0 ) which = argv[ ++i ];
+      else usage( argv[ 0 ] );
+   }
+
+   if( n < 2 || reps < 1 ) usage( argv[ 0 ] );
+
+   bool found = false;
+   for( size_t k = 0; k < NUM_GENERATORS; ++k )
+   {
+      if( strcmp( which, "all" ) != 0 && strcmp( which, generators[ k ].name ) != 0 ) continue;
+      found = true;
+
+      EdgeList list = { .name = generators[ k ].name };
+      generators[ k ].fn( &list, n );
+
+      run( &list, reps );
+
+      EdgeList_Destroy( &list );
+   }
+
+   if( !found ) usage( argv[ 0 ] );
+
+   return 0;
+}